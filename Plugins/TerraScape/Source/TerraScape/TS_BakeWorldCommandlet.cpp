@@ -0,0 +1,195 @@
+/**
+ * @file TS_BakeWorldCommandlet.cpp
+ * @brief Commandlet that pre-generates a block of chunks into region files
+ * @author Keves
+ * @version 1.0
+ */
+
+#include "TS_BakeWorldCommandlet.h"
+#include "TS_Stats.h"
+#include "TS_ChunkManager.h"
+#include "TS_RegionFile.h"
+#include "TS_WorldGenerator.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Misc/Parse.h"
+#include "UObject/Package.h"
+#include "UObject/StrongObjectPtr.h"
+
+UTS_BakeWorldCommandlet::UTS_BakeWorldCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = true;
+	LogToConsole = true;
+}
+
+int32 UTS_BakeWorldCommandlet::Main(const FString& Params)
+{
+	FIntVector MinChunk;
+	FIntVector MaxChunk;
+	if (!ParseChunkID(Params, TEXT("Min="), MinChunk) || !ParseChunkID(Params, TEXT("Max="), MaxChunk)
+		|| MinChunk.X > MaxChunk.X || MinChunk.Y > MaxChunk.Y || MinChunk.Z > MaxChunk.Z)
+	{
+		UE_LOG(LogTerraScape, Error, TEXT("TerraScape: Bake needs an inclusive chunk box, e.g. -Min=-16,-16,-2 -Max=15,15,1"));
+		return 1;
+	}
+
+	// A manager that never joins a world: its defaults (or those of the game's chunk manager Blueprint given
+	// with -Manager) are the game's chunk layout and world generation asset, and it owns the generator.
+	UClass* ChunkManagerClass = UTS_ChunkManager::StaticClass();
+	FString ManagerClassPath;
+	if (FParse::Value(*Params, TEXT("Manager="), ManagerClassPath))
+	{
+		ChunkManagerClass = LoadClass<UTS_ChunkManager>(nullptr, *ManagerClassPath);
+		if (!ChunkManagerClass)
+		{
+			UE_LOG(LogTerraScape, Error, TEXT("TerraScape: Could not load chunk manager class %s"), *ManagerClassPath);
+			return 1;
+		}
+	}
+
+	// Nothing else references it, so keep it (and the generator the workers use) alive through any GC during the bake
+	TStrongObjectPtr<UTS_ChunkManager> ChunkManager(NewObject<UTS_ChunkManager>(GetTransientPackage(), ChunkManagerClass));
+	FParse::Value(*Params, TEXT("ChunkSize="), ChunkManager->ChunkSize);
+	FParse::Value(*Params, TEXT("VoxelSize="), ChunkManager->VoxelSize);
+	FParse::Value(*Params, TEXT("ChunkGap="), ChunkManager->ChunkGap);
+
+	UTS_WorldGenerator* WorldGenerator = ChunkManager->GetWorldGenerator();
+	if (!WorldGenerator || !UTS_ChunkManager::IsValidChunkSize(ChunkManager->ChunkSize))
+	{
+		UE_LOG(LogTerraScape, Error, TEXT("TerraScape: Bake has no world generator or an invalid chunk size (%d, must be 1-%d)"),
+			ChunkManager->ChunkSize, FTS_AsyncMeshGenerationTask::MaxGridSize);
+		return 1;
+	}
+
+	// Same asset and the same path into the generator as the runtime's BeginPlay
+	FString ParametersPath;
+	if (FParse::Value(*Params, TEXT("Params="), ParametersPath))
+	{
+		ChunkManager->WorldGenParameters = LoadObject<UTS_WorldGenParametersAsset>(nullptr, *ParametersPath);
+		if (!ChunkManager->WorldGenParameters)
+		{
+			UE_LOG(LogTerraScape, Error, TEXT("TerraScape: Could not load world generation parameters %s"), *ParametersPath);
+			return 1;
+		}
+	}
+	ChunkManager->ApplyWorldGenParameters();
+
+	// A seed the runtime doesn't use changes the fingerprint, so the game ignores these files rather than mixing them in
+	int32 Seed = 0;
+	if (FParse::Value(*Params, TEXT("Seed="), Seed))
+	{
+		WorldGenerator->RegenerateWorld(Seed);
+	}
+	ChunkManager->bUseProceduralGeneration = true;
+	const uint32 GeneratorFingerprint = ChunkManager->GetGeneratorFingerprint();
+
+	FString WorldName = ChunkManager->WorldSaveName;
+	FParse::Value(*Params, TEXT("World="), WorldName);
+	FString CompressionName = ChunkManager->RegionCompressionFormat.ToString();
+	FParse::Value(*Params, TEXT("Compression="), CompressionName);
+	const FName CompressionFormat = CompressionName == TEXT("None") ? NAME_None : FName(*CompressionName);
+	const bool bMesh = FParse::Param(*Params, TEXT("Mesh"));
+
+	const FString Directory = UTS_ChunkManager::GetWorldSaveDirectory(WorldName);
+	if (FParse::Param(*Params, TEXT("Clean")))
+	{
+		IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	}
+
+	const int32 ChunkSize = ChunkManager->ChunkSize;
+	const float VoxelSize = ChunkManager->VoxelSize;
+	const FIntVector BoxSize = MaxChunk - MinChunk + FIntVector(1);
+	const int64 TotalChunks = int64(BoxSize.X) * BoxSize.Y * BoxSize.Z;
+	TSharedRef<FTS_RegionStore, ESPMode::ThreadSafe> RegionStore = MakeShared<FTS_RegionStore, ESPMode::ThreadSafe>(
+		Directory, ChunkSize, GeneratorFingerprint, CompressionFormat);
+
+	UE_LOG(LogTerraScape, Display, TEXT("TerraScape: Baking %lld chunks %s..%s (seed %d, chunk size %d, fingerprint %08x) into %s"),
+		TotalChunks, *MinChunk.ToString(), *MaxChunk.ToString(), WorldGenerator->WorldGenParameters.WorldSeed, ChunkSize,
+		GeneratorFingerprint, *Directory);
+
+	std::atomic<int64> NumUniform{ 0 };
+	std::atomic<int64> NumFailed{ 0 };
+	std::atomic<int64> NumTriangles{ 0 };
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Batches bound the progress interval; chunks within one run on every task graph worker
+	const int64 BatchSize = 4096;
+	for (int64 BatchStart = 0; BatchStart < TotalChunks; BatchStart += BatchSize)
+	{
+		const int32 BatchCount = static_cast<int32>(FMath::Min(BatchSize, TotalChunks - BatchStart));
+		ParallelFor(BatchCount, [&](int32 BatchIndex)
+		{
+			// X fastest, so neighbouring chunks (and their region files) are baked together
+			const int64 ChunkIndex = BatchStart + BatchIndex;
+			const FIntVector ChunkID = MinChunk + FIntVector(
+				static_cast<int32>(ChunkIndex % BoxSize.X),
+				static_cast<int32>((ChunkIndex / BoxSize.X) % BoxSize.Y),
+				static_cast<int32>(ChunkIndex / (int64(BoxSize.X) * BoxSize.Y)));
+			const FVector ChunkWorldPos = ChunkManager->CalculateChunkWorldPosition(ChunkID);
+
+			// Same task the chunk manager runs, so baked chunks match runtime ones; mips are rebuilt on load
+			FTS_AsyncVoxelGenerationTask VoxelTask(ChunkID, ChunkSize, VoxelSize, ChunkWorldPos, WorldGenerator, true);
+			VoxelTask.DoWork();
+
+			if (VoxelTask.bIsUniform)
+			{
+				NumUniform++;
+				if (!RegionStore->SaveChunk(ChunkID, nullptr, VoxelTask.UniformMaterialID))
+				{
+					NumFailed++;
+				}
+				return;
+			}
+
+			if (!RegionStore->SaveChunk(ChunkID, &VoxelTask.VoxelStorage, 0))
+			{
+				NumFailed++;
+			}
+
+			if (bMesh)
+			{
+				// Collision-only like a dedicated server, without neighbours: the runtime meshes against its own LODs
+				FTS_ChunkVoxelSnapshot Snapshot = MakeShared<FTS_ChunkVoxelStorage, ESPMode::ThreadSafe>(MoveTemp(VoxelTask.VoxelStorage));
+				FTS_AsyncMeshGenerationTask MeshTask(ChunkID, Snapshot, ChunkSize, VoxelSize, ChunkWorldPos, nullptr, 0,
+					ChunkManager->MeshingMode, FTS_ChunkApron(), true);
+				MeshTask.DoWork();
+				NumTriangles += MeshTask.Triangles.Num() / 3;
+			}
+		});
+
+		const int64 ChunksDone = BatchStart + BatchCount;
+		const double Elapsed = FPlatformTime::Seconds() - StartTime;
+		UE_LOG(LogTerraScape, Display, TEXT("TerraScape: Baked %lld / %lld chunks (%.0f chunks/s)"),
+			ChunksDone, TotalChunks, Elapsed > 0.0 ? ChunksDone / Elapsed : 0.0);
+	}
+
+	RegionStore->WaitForPendingSaves();
+	const double TotalSeconds = FPlatformTime::Seconds() - StartTime;
+
+	UE_LOG(LogTerraScape, Display, TEXT("TerraScape: Bake finished in %.2fs, %.0f chunks/s (%lld uniform, %lld failed%s)"),
+		TotalSeconds, TotalSeconds > 0.0 ? TotalChunks / TotalSeconds : 0.0, NumUniform.load(), NumFailed.load(),
+		bMesh ? *FString::Printf(TEXT(", %lld collision triangles"), NumTriangles.load()) : TEXT(""));
+
+	return NumFailed.load() == 0 ? 0 : 1;
+}
+
+bool UTS_BakeWorldCommandlet::ParseChunkID(const FString& Params, const TCHAR* Key, FIntVector& OutChunkID)
+{
+	FString Value;
+	if (!FParse::Value(*Params, Key, Value, false))
+	{
+		return false;
+	}
+
+	TArray<FString> Components;
+	Value.ParseIntoArray(Components, TEXT(","));
+	if (Components.Num() != 3)
+	{
+		return false;
+	}
+
+	OutChunkID = FIntVector(FCString::Atoi(*Components[0]), FCString::Atoi(*Components[1]), FCString::Atoi(*Components[2]));
+	return true;
+}
@@ -0,0 +1,44 @@
+/**
+ * @file TS_BakeWorldCommandlet.h
+ * @brief Commandlet that pre-generates a block of chunks into region files
+ * @author Keves
+ * @version 1.0
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TS_BakeWorldCommandlet.generated.h"
+
+/**
+ * @brief Generates every chunk of a chunk-space box on all cores and stores it in the world's region files
+ * A chunk manager with persistence enabled then loads the baked chunks instead of generating them.
+ * Runs headless (-nullrhi); chunk size, voxel size, gap and the world generation asset come from the
+ * chunk manager defaults unless overridden. Region files record a fingerprint of these settings, and the
+ * game ignores files whose fingerprint doesn't match its own instead of mixing them with generated chunks.
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=TS_BakeWorld -Min=X,Y,Z -Max=X,Y,Z [-Manager=/Game/Path/BP.BP_C]
+ *        [-Params=/Game/Path/Asset] [-Seed=N] [-World=Name] [-Compression=LZ4|Oodle|Zlib|None] [-ChunkSize=N]
+ *        [-VoxelSize=F] [-ChunkGap=F] [-Mesh] [-Clean] -nullrhi
+ *
+ * -Min/-Max are inclusive chunk IDs, -Manager the game's chunk manager class (its defaults are used),
+ * -Params a UTS_WorldGenParametersAsset replacing the manager's WorldGenParameters, -Seed overrides its seed,
+ * -Mesh also builds each chunk's collision mesh (to check and time meshing; meshes aren't stored) and
+ * -Clean deletes the world's region files first.
+ */
+UCLASS()
+class TERRA_SCAPE_API UTS_BakeWorldCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UTS_BakeWorldCommandlet();
+
+	// UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	/** Parse "X,Y,Z" from a -Key=X,Y,Z switch */
+	static bool ParseChunkID(const FString& Params, const TCHAR* Key, FIntVector& OutChunkID);
+};
@@ -96,8 +96,20 @@ FTS_BiomeBlend UTS_BiomeManager::GetBiomeBlendAtLocation(float X, float Y, float
 
 int32 UTS_BiomeManager::GetMaterialIDAtLocation(float X, float Y, float Z, float Height) const
 {
-	FTS_Biome Biome = GetBiomeAtLocation(X, Y, Z);
-	
+	float BiomeHeight, Moisture, Temperature;
+	CalculateEnvironmentalFactors(X, Y, Z, BiomeHeight, Moisture, Temperature);
+
+	return GetMaterialIDForClimate(BiomeHeight, Moisture, Temperature, Height);
+}
+
+int32 UTS_BiomeManager::GetMaterialIDForClimate(float BiomeHeight, float Moisture, float Temperature, float TerrainHeight) const
+{
+	const int32 BiomeIndex = FindBestBiomeIndex(BiomeHeight, Moisture, Temperature);
+	return GetBiomeMaterialID(BiomeIndex != INDEX_NONE ? Biomes[BiomeIndex] : FTS_Biome(), TerrainHeight);
+}
+
+int32 UTS_BiomeManager::GetBiomeMaterialID(const FTS_Biome& Biome, float Height)
+{
 	// Simple material selection based on height within biome
 	float HeightNormalized = FMath::GetMappedRangeValueClamped(
 		Biome.HeightRange,
@@ -109,6 +121,11 @@ int32 UTS_BiomeManager::GetMaterialIDAtLocation(float X, float Y, float Z, float
 	return HeightNormalized < 0.5f ? Biome.PrimaryMaterialID : Biome.SecondaryMaterialID;
 }
 
+void UTS_BiomeManager::CalculateColumnClimate(float X, float Y, float& OutHeight, float& OutMoisture, float& OutTemperature) const
+{
+	CalculateEnvironmentalFactors(X, Y, 0.0f, OutHeight, OutMoisture, OutTemperature);
+}
+
 void UTS_BiomeManager::AddBiome(const FTS_Biome& Biome)
 {
 	Biomes.Add(Biome);
@@ -134,6 +151,37 @@ TArray<FTS_Biome> UTS_BiomeManager::GetAllBiomes() const
 void UTS_BiomeManager::CalculateEnvironmentalFactors(float X, float Y, float Z, float& OutHeight, float& OutMoisture, float& OutTemperature) const
 {
 	// Height calculation using terrain noise
+	OutHeight = UTS_ProceduralNoise::GetTerrainHeight(X, Y, GetHeightNoiseParameters());
+	
+	// Climate is a column property, sampled at Z = 0 so every voxel of a column agrees
+	OutMoisture = (UTS_ProceduralNoise::FractalNoise(X, Y, 0.0f, GetMoistureNoiseParameters()) + 1.0f) * 0.5f;
+	OutMoisture = FMath::Clamp(OutMoisture, 0.0f, 1.0f);
+	
+	// Temperature calculation using another noise layer
+	OutTemperature = (UTS_ProceduralNoise::FractalNoise(X, Y, 0.0f, GetTemperatureNoiseParameters()) + 1.0f) * 0.5f;
+	OutTemperature = FMath::Clamp(OutTemperature, 0.0f, 1.0f);
+}
+
+void UTS_BiomeManager::CalculateColumnClimateRow(const FVector& Start, float StepX, TArrayView<float> OutHeight, TArrayView<float> OutMoisture, TArrayView<float> OutTemperature) const
+{
+	check(OutMoisture.Num() == OutHeight.Num() && OutTemperature.Num() == OutHeight.Num());
+
+	const FVector RowStart(Start.X, Start.Y, 0.0f);
+	const FVector RowStep(StepX, 0.0f, 0.0f);
+
+	UTS_ProceduralNoise::GetTerrainHeightBatch(RowStart, RowStep, GetHeightNoiseParameters(), OutHeight);
+	UTS_ProceduralNoise::FractalNoiseBatch(RowStart, RowStep, GetMoistureNoiseParameters(), OutMoisture);
+	UTS_ProceduralNoise::FractalNoiseBatch(RowStart, RowStep, GetTemperatureNoiseParameters(), OutTemperature);
+
+	for (int32 Index = 0; Index < OutHeight.Num(); Index++)
+	{
+		OutMoisture[Index] = FMath::Clamp((OutMoisture[Index] + 1.0f) * 0.5f, 0.0f, 1.0f);
+		OutTemperature[Index] = FMath::Clamp((OutTemperature[Index] + 1.0f) * 0.5f, 0.0f, 1.0f);
+	}
+}
+
+FTS_NoiseParameters UTS_BiomeManager::GetHeightNoiseParameters()
+{
 	FTS_NoiseParameters HeightParams;
 	HeightParams.Frequency = 0.005f;
 	HeightParams.Amplitude = 200.0f;
@@ -141,10 +189,11 @@ void UTS_BiomeManager::CalculateEnvironmentalFactors(float X, float Y, float Z,
 	HeightParams.Persistence = 0.5f;
 	HeightParams.Lacunarity = 2.0f;
 	HeightParams.Seed = 12345;
-	
-	OutHeight = UTS_ProceduralNoise::GetTerrainHeight(X, Y, HeightParams);
-	
-	// Moisture calculation using different noise
+	return HeightParams;
+}
+
+FTS_NoiseParameters UTS_BiomeManager::GetMoistureNoiseParameters()
+{
 	FTS_NoiseParameters MoistureParams;
 	MoistureParams.Frequency = 0.003f;
 	MoistureParams.Amplitude = 1.0f;
@@ -153,11 +202,11 @@ void UTS_BiomeManager::CalculateEnvironmentalFactors(float X, float Y, float Z,
 	MoistureParams.Lacunarity = 2.0f;
 	MoistureParams.Seed = 54321;
 	MoistureParams.Offset = FVector(1000.0f, 1000.0f, 0.0f);
-	
-	OutMoisture = (UTS_ProceduralNoise::FractalNoise(X, Y, Z, MoistureParams) + 1.0f) * 0.5f;
-	OutMoisture = FMath::Clamp(OutMoisture, 0.0f, 1.0f);
-	
-	// Temperature calculation using another noise layer
+	return MoistureParams;
+}
+
+FTS_NoiseParameters UTS_BiomeManager::GetTemperatureNoiseParameters()
+{
 	FTS_NoiseParameters TemperatureParams;
 	TemperatureParams.Frequency = 0.002f;
 	TemperatureParams.Amplitude = 1.0f;
@@ -166,18 +215,23 @@ void UTS_BiomeManager::CalculateEnvironmentalFactors(float X, float Y, float Z,
 	TemperatureParams.Lacunarity = 2.0f;
 	TemperatureParams.Seed = 98765;
 	TemperatureParams.Offset = FVector(-500.0f, -500.0f, 0.0f);
-	
-	OutTemperature = (UTS_ProceduralNoise::FractalNoise(X, Y, Z, TemperatureParams) + 1.0f) * 0.5f;
-	OutTemperature = FMath::Clamp(OutTemperature, 0.0f, 1.0f);
+	return TemperatureParams;
 }
 
 FTS_Biome UTS_BiomeManager::FindBestBiome(float Height, float Moisture, float Temperature) const
 {
-	FTS_Biome BestBiome;
+	const int32 BiomeIndex = FindBestBiomeIndex(Height, Moisture, Temperature);
+	return BiomeIndex != INDEX_NONE ? Biomes[BiomeIndex] : FTS_Biome();
+}
+
+int32 UTS_BiomeManager::FindBestBiomeIndex(float Height, float Moisture, float Temperature) const
+{
+	int32 BestIndex = INDEX_NONE;
 	float BestScore = -1.0f;
 	
-	for (const FTS_Biome& Biome : Biomes)
+	for (int32 BiomeIndex = 0; BiomeIndex < Biomes.Num(); BiomeIndex++)
 	{
+		const FTS_Biome& Biome = Biomes[BiomeIndex];
 		if (!Biome.bEnabled)
 		{
 			continue;
@@ -233,11 +287,11 @@ FTS_Biome UTS_BiomeManager::FindBestBiome(float Height, float Moisture, float Te
 		if (TotalScore > BestScore)
 		{
 			BestScore = TotalScore;
-			BestBiome = Biome;
+			BestIndex = BiomeIndex;
 		}
 	}
 	
-	return BestBiome;
+	return BestIndex;
 }
 
 void UTS_BiomeManager::CalculateBiomeTransition(float X, float Y, float Z, const FTS_Biome& PrimaryBiome, FTS_Biome& OutSecondaryBiome, float& OutBlendFactor) const
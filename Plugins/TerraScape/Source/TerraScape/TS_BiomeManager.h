@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "Engine/Engine.h"
+#include "TS_ProceduralNoise.h"
 #include "TS_BiomeManager.generated.h"
 
 /**
@@ -128,6 +129,37 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "TerraScape | Voxel | Procedural")
 	int32 GetMaterialIDAtLocation(float X, float Y, float Z, float Height) const;
 
+	/**
+	 * Get material ID for a column from precomputed climate values
+	 * Used by the chunk heightmap pass so the climate noise is sampled once per column
+	 * @param BiomeHeight - Biome height value from CalculateColumnClimate
+	 * @param Moisture - Moisture value from CalculateColumnClimate
+	 * @param Temperature - Temperature value from CalculateColumnClimate
+	 * @param TerrainHeight - Terrain height of the column
+	 * @return Material ID
+	 */
+	int32 GetMaterialIDForClimate(float BiomeHeight, float Moisture, float Temperature, float TerrainHeight) const;
+
+	/**
+	 * Calculate climate for a terrain column (climate does not vary with Z)
+	 * @param X, Y - World coordinates
+	 * @param OutHeight - Output biome height
+	 * @param OutMoisture - Output moisture
+	 * @param OutTemperature - Output temperature
+	 */
+	void CalculateColumnClimate(float X, float Y, float& OutHeight, float& OutMoisture, float& OutTemperature) const;
+
+	/**
+	 * Calculate climate for a row of terrain columns using the batch noise path
+	 * Column i is at (Start.X + StepX * i, Start.Y); results match CalculateColumnClimate
+	 * @param Start - World coordinates of the first column (Z is ignored)
+	 * @param StepX - World space distance between columns
+	 * @param OutHeight - Output biome heights, one per column
+	 * @param OutMoisture - Output moisture, same size as OutHeight
+	 * @param OutTemperature - Output temperature, same size as OutHeight
+	 */
+	void CalculateColumnClimateRow(const FVector& Start, float StepX, TArrayView<float> OutHeight, TArrayView<float> OutMoisture, TArrayView<float> OutTemperature) const;
+
 	/**
 	 * Add a new biome to the manager
 	 * @param Biome - Biome to add
@@ -166,6 +198,11 @@ private:
 	 */
 	void CalculateEnvironmentalFactors(float X, float Y, float Z, float& OutHeight, float& OutMoisture, float& OutTemperature) const;
 
+	/** Noise parameters for the biome height, moisture and temperature layers */
+	static FTS_NoiseParameters GetHeightNoiseParameters();
+	static FTS_NoiseParameters GetMoistureNoiseParameters();
+	static FTS_NoiseParameters GetTemperatureNoiseParameters();
+
 	/**
 	 * Find best matching biome for given environmental factors
 	 * @param Height - Height value
@@ -175,6 +212,20 @@ private:
 	 */
 	FTS_Biome FindBestBiome(float Height, float Moisture, float Temperature) const;
 
+	/**
+	 * Find index of best matching biome without copying it
+	 * @return Index into Biomes, or INDEX_NONE if no biome is enabled
+	 */
+	int32 FindBestBiomeIndex(float Height, float Moisture, float Temperature) const;
+
+	/**
+	 * Pick primary or secondary material of a biome based on terrain height
+	 * @param Biome - Biome to pick from
+	 * @param Height - Terrain height
+	 * @return Material ID
+	 */
+	static int32 GetBiomeMaterialID(const FTS_Biome& Biome, float Height);
+
 	/**
 	 * Calculate biome transition blend
 	 * @param X, Y, Z - World coordinates
@@ -13,17 +13,26 @@
 #include "TS_MaterialData.h"
 #include "TS_WorldGenerator.h"
 #include "Async/AsyncWork.h"
+#include "Misc/Paths.h"
 
 UTS_ChunkManager::UTS_ChunkManager()
 {
 	// Enable ticking to check for completed async tasks
 	PrimaryComponentTick.bCanEverTick = true;
-	PrimaryComponentTick.TickInterval = 0.1f; // Check every 100ms
+	PrimaryComponentTick.TickInterval = 0.0f; // Every frame: finished work is picked up without polling delay
 	
 	// Initialize properties (required for UPROPERTY)
 	ChunkSize = 32;
 	VoxelSize = 100.0f; // 100 units per voxel
-	MaxConcurrentAsyncTasks = 8;
+	MaxConcurrentAsyncTasks = 0; // One per worker thread
+	WorkerThreadCount = 0; // One per physical core
+	WorkerThreadPriority = ETS_WorkerThreadPriority::BelowNormal;
+	WorkerAffinityMask = 0;
+	MeshingMode = ETS_MeshingMode::Greedy;
+	MeshUploadBudgetMs = 2.0f;
+	MeshComponentPoolWarmUp = 64;
+	MeshComponentPoolMaxSize = 512;
+	MeshContent = ETS_ChunkMeshContent::Auto;
 	
 	// Automatically set ChunkGap to half chunk size to close gaps
 	ChunkGap = -(ChunkSize * VoxelSize) / 2.0f; // -1600 for default values
@@ -33,22 +42,73 @@ UTS_ChunkManager::UTS_ChunkManager()
 	LOD0Distance = 2000.0f; // Full detail
 	LOD1Distance = 4000.0f; // Reduced detail
 	LOD2Distance = 8000.0f; // Minimal detail
+	LODReduction = ETS_LODReduction::Majority;
 	PlayerReference = nullptr;
+
+	// Initialize streaming settings
+	bEnableStreaming = true;
+	StreamingRadiusXY = 8;
+	StreamingRadiusZ = 2;
+	StreamingHysteresis = 2;
+	MaxChunkLoadsPerTick = 16;
+	MaxChunkUnloadsPerTick = 16;
 	
 	// Create material manager
 	MaterialManager = CreateDefaultSubobject<UTS_MaterialManager>(TEXT("MaterialManager"));
 
 	// Create world generator
 	WorldGenerator = CreateDefaultSubobject<UTS_WorldGenerator>(TEXT("WorldGenerator"));
+
+	// Workers report finished tasks here
+	CompletionQueue = MakeShared<FTS_ChunkTaskCompletionQueue, ESPMode::ThreadSafe>();
+
+	// Queued work is ranked by distance to the chunk centre and the LOD it will get
+	SchedulingViewAngle = 120.0f;
+	auto GetChunkCenter = [this](const FIntVector& ChunkID)
+	{
+		return CalculateChunkWorldPosition(ChunkID) + FVector(ChunkSize * VoxelSize * 0.5f);
+	};
+	auto GetChunkLOD = [this](const FIntVector& ChunkID)
+	{
+		return GetChunkLODLevel(ChunkID);
+	};
+	MeshScheduler.SetChunkCallbacks(GetChunkCenter, GetChunkLOD);
+	GenerationScheduler.SetChunkCallbacks(GetChunkCenter, GetChunkLOD);
+	UploadScheduler.SetChunkCallbacks(GetChunkCenter, GetChunkLOD);
+}
+
+void UTS_ChunkManager::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Set from code or a Blueprint the editor clamp doesn't apply; nothing could be meshed
+	if (!IsValidChunkSize(ChunkSize))
+	{
+		UE_LOG(LogTerraScape, Error, TEXT("TerraScape: ChunkSize %d is outside 1-%d, chunk manager disabled"),
+			ChunkSize, FTS_AsyncMeshGenerationTask::MaxGridSize);
+		SetComponentTickEnabled(false);
+		return;
+	}
+
+	// Before any chunk is generated or a region file opened
+	ApplyWorldGenParameters();
+
+	// Create the first chunks' components now rather than while streaming in
+	WarmUpMeshComponentPool();
 }
 
 void UTS_ChunkManager::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	SCOPE_CYCLE_COUNTER(STAT_TerraScape_Tick);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UTS_ChunkManager::TickComponent);
 
-	// Check for completed async mesh generation tasks
-	CheckAsyncMeshTasks();
+	// Hand off whatever the workers finished since the last frame
+	ProcessCompletedTasks();
 	
+	// Follow the player: a bounded number of loads and unloads per tick
+	UpdateStreaming();
+
 	// Update LOD for chunks (less frequently to avoid performance impact)
 	static float LODUpdateTimer = 0.0f;
 	LODUpdateTimer += DeltaTime;
@@ -57,951 +117,2216 @@ void UTS_ChunkManager::TickComponent(float DeltaTime, ELevelTick TickType, FActo
 		UpdateChunkLOD();
 		LODUpdateTimer = 0.0f;
 	}
+
+	UpdateStats();
+}
+
+void UTS_ChunkManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Make sure no worker is still touching the world generator or material manager
+	ClearAllChunks();
+
+	// Unloaded chunks were queued for saving, get them onto disk before the workers go away
+	if (RegionStore.IsValid())
+	{
+		RegionStore->WaitForPendingSaves();
+		RegionStore.Reset();
+	}
+	WorkerPool.Stop();
+	bWorkerPoolFailed = false;
+	EmptyMeshComponentPool();
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void UTS_ChunkManager::CreateChunk(const FIntVector& ChunkID)
 {
+	if (!IsValidChunkSize(ChunkSize))
+	{
+		UE_LOG(LogTerraScape, Error, TEXT("Cannot create chunk %s, ChunkSize %d is outside 1-%d"),
+			*ChunkID.ToString(), ChunkSize, FTS_AsyncMeshGenerationTask::MaxGridSize);
+		return;
+	}
+
 	// Don't create if already exists
-	if (LoadedChunks.Contains(ChunkID))
+	if (ChunkRecords.Contains(ChunkID))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Chunk %s already exists"), *ChunkID.ToString());
+		UE_LOG(LogTerraScape, Warning, TEXT("Chunk %s already exists"), *ChunkID.ToString());
 		return;
 	}
 
-	// Create chunk data
-	FTS_Chunk NewChunk;
-	NewChunk.ChunkID = ChunkID;
+	// Store the chunk - voxel data is filled in by the async generation task,
+	// the mesh component is only created once there is a mesh to show
+	FTS_ChunkRecord& Record = ChunkRecords[ChunkRecords.Add(ChunkID)];
 	// Calculate chunk world position using single source of truth
-	NewChunk.WorldPosition = CalculateChunkWorldPosition(ChunkID);
-	NewChunk.bIsLoaded = true;
+	Record.WorldPosition = CalculateChunkWorldPosition(ChunkID);
+	Record.RequestTime = FPlatformTime::Seconds();
 
-	// Generate voxels (procedural or test)
-	TArray<FTS_Voxel> VoxelData = bUseProceduralGeneration ? GenerateProceduralVoxels(ChunkID) : GenerateTestVoxels(ChunkID);
+	// Might be outside every streaming volume; streaming clears this for the chunks it requests itself
+	bStreamingUnloadListDirty = true;
 
-	// Store the chunk and its data
-	LoadedChunks.Add(ChunkID, NewChunk);
-	ChunkVoxelData.Add(ChunkID, VoxelData);
+	UE_LOG(LogTerraScape, Verbose, TEXT("Created chunk %s at position %s"),
+		*ChunkID.ToString(), *Record.WorldPosition.ToString());
 
-	// Create mesh component
-	UProceduralMeshComponent* MeshComp = NewObject<UProceduralMeshComponent>(this);
-	MeshComp->RegisterComponent();
-	MeshComp->AttachToComponent(GetOwner()->GetRootComponent(), FAttachmentTransformRules::KeepWorldTransform);
-	MeshComp->SetWorldLocation(NewChunk.WorldPosition);
-	
-	ChunkMeshes.Add(ChunkID, MeshComp);
-	
-	UE_LOG(LogTemp, Log, TEXT("Created chunk %s at position %s"), 
-		*ChunkID.ToString(), *NewChunk.WorldPosition.ToString());
+	// Ensure MaterialManager is initialized before any async task can use it (collision meshes never look materials up)
+	if (MaterialManager && MaterialDataTable && !MaterialManager->IsInitialized() && !IsCollisionOnly())
+	{
+		MaterialManager->InitializeMaterialDataTable(MaterialDataTable);
+		UE_LOG(LogTerraScape, Log, TEXT("TerraScape: Material data table initialized for async task"));
+	}
 	
 	// Check if we're at the limit of concurrent async tasks
-	if (AsyncMeshTasks.Num() >= MaxConcurrentAsyncTasks)
+	if (GetNumAsyncTasks() >= GetMaxConcurrentAsyncTasks())
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Too many concurrent async tasks (%d/%d), adding chunk %s to queue"), 
-			AsyncMeshTasks.Num(), MaxConcurrentAsyncTasks, *ChunkID.ToString());
-		// Add to queue for later mesh generation
-		PendingMeshGenerationQueue.Add(ChunkID);
+		UE_LOG(LogTerraScape, Verbose, TEXT("Too many concurrent async tasks (%d/%d), adding chunk %s to generation queue"), 
+			GetNumAsyncTasks(), GetMaxConcurrentAsyncTasks(), *ChunkID.ToString());
+		// Add to queue for later voxel generation
+		GenerationScheduler.Enqueue(ChunkID);
 		return;
 	}
-	
-	// Debug: Check voxel data before async generation
-	int32 SolidVoxels = 0;
-	for (const FTS_Voxel& Voxel : VoxelData)
+
+	StartVoxelGeneration(ChunkID);
+}
+
+void UTS_ChunkManager::DeleteChunk(const FIntVector& ChunkID)
+{
+	FTS_ChunkRecord* Record = ChunkRecords.Find(ChunkID);
+	if (!Record)
 	{
-		if (Voxel.IsSolid())
+		UE_LOG(LogTerraScape, Warning, TEXT("Chunk %s does not exist"), *ChunkID.ToString());
+		return;
+	}
+
+	// Cancel pending async work without waiting for tasks that are already running
+	CancelGenerationTask(*Record);
+	GenerationScheduler.Remove(ChunkID);
+
+	CancelMeshTask(*Record);
+	DiscardReadyMesh(*Record);
+	MeshScheduler.Remove(ChunkID);
+
+	// Hand the mesh component back to the pool for the next chunk
+	if (Record->Mesh)
+	{
+		ReleaseMeshComponent(Record->Mesh);
+		Record->Mesh = nullptr;
+		NumChunkMeshes--;
+		MeshMemoryBytes -= Record->MeshBytes;
+		Record->MeshBytes = 0;
+	}
+
+	// Keep edits (and optionally the generated voxels) for the next time the chunk loads
+	SaveChunk(*Record);
+
+	// Neighbours culled faces against this chunk, they need them back now
+	if (Record->HasVoxelData())
+	{
+		Record->VoxelData.Reset();
+		Record->bIsUniform = false;
+		RemeshNeighborsOfChunk(*Record);
+	}
+
+	// Remove chunk and its data, unlinking it from its neighbours
+	ChunkRecords.Remove(ChunkID);
+
+	// Deleted from gameplay inside a streaming volume: streaming has to come back for it
+	RestartStreamingAround(ChunkID);
+
+	UE_LOG(LogTerraScape, Verbose, TEXT("Deleted chunk %s"), *ChunkID.ToString());
+}
+
+bool UTS_ChunkManager::IsChunkLoaded(const FIntVector& ChunkID) const
+{
+	return ChunkRecords.Contains(ChunkID);
+}
+
+int32 UTS_ChunkManager::GetLoadedChunkCount() const
+{
+	return ChunkRecords.Num();
+}
+
+int64 UTS_ChunkManager::GetVoxelMemoryUsage() const
+{
+	int64 TotalBytes = ChunkRecords.GetAllocatedSize();
+	for (const FTS_ChunkRecord& Record : ChunkRecords)
+	{
+		if (Record.VoxelData.IsValid())
 		{
-			SolidVoxels++;
+			TotalBytes += Record.VoxelData->GetAllocatedSize();
 		}
 	}
-	UE_LOG(LogTemp, Log, TEXT("Chunk %s: %d solid voxels out of %d total, VoxelSize=%.1f, ChunkSize=%d"), 
-		*ChunkID.ToString(), SolidVoxels, VoxelData.Num(), VoxelSize, ChunkSize);
+	return TotalBytes;
+}
+
+int64 UTS_ChunkManager::GetMeshMemoryUsage() const
+{
+	return MeshMemoryBytes;
+}
 
-	// Ensure MaterialManager is initialized before starting async task
-	if (MaterialManager && MaterialDataTable && !MaterialManager->IsInitialized())
+void UTS_ChunkManager::UpdateStats()
+{
+#if STATS
+	SET_DWORD_STAT(STAT_TerraScape_LoadedChunks, ChunkRecords.Num());
+	SET_DWORD_STAT(STAT_TerraScape_MeshedChunks, NumChunkMeshes);
+	SET_DWORD_STAT(STAT_TerraScape_GenerationQueue, GenerationScheduler.Num());
+	SET_DWORD_STAT(STAT_TerraScape_MeshQueue, MeshScheduler.Num());
+	SET_DWORD_STAT(STAT_TerraScape_UploadQueue, UploadScheduler.Num());
+	SET_DWORD_STAT(STAT_TerraScape_GenerationTasks, NumGenerationTasks);
+	SET_DWORD_STAT(STAT_TerraScape_MeshTasks, NumMeshTasks);
+	SET_DWORD_STAT(STAT_TerraScape_PendingSaves, RegionStore.IsValid() ? RegionStore->GetNumPendingSaves() : 0);
+	SET_MEMORY_STAT(STAT_TerraScape_MeshMemory, MeshMemoryBytes);
+
+	// Walks every chunk, so only while stats are being captured
+	if (FThreadStats::IsCollectingData())
 	{
-		MaterialManager->InitializeMaterialDataTable(MaterialDataTable);
-		UE_LOG(LogTemp, Log, TEXT("TerraScape: Material data table initialized for async task"));
+		SET_MEMORY_STAT(STAT_TerraScape_VoxelMemory, GetVoxelMemoryUsage());
 	}
+#endif
+}
 
-	// Get LOD level for this chunk
-	int32 LODLevel = GetChunkLODLevel(ChunkID);
-	
-	
-	// Start async mesh generation
-	FAsyncTask<FTS_AsyncMeshGenerationTask>* AsyncTask = new FAsyncTask<FTS_AsyncMeshGenerationTask>(
-		ChunkID, VoxelData, ChunkSize, VoxelSize, NewChunk.WorldPosition, MaterialManager, LODLevel);
-	
-	AsyncTask->StartBackgroundTask();
-	AsyncMeshTasks.Add(ChunkID, AsyncTask);
-	
-	UE_LOG(LogTemp, Log, TEXT("Started async mesh generation for chunk %s (%d/%d tasks)"), 
-		*ChunkID.ToString(), AsyncMeshTasks.Num(), MaxConcurrentAsyncTasks);
+void UTS_ChunkManager::SaveAllChunks()
+{
+	int32 ChunksSaved = 0;
+	for (FTS_ChunkRecord& Record : ChunkRecords)
+	{
+		ChunksSaved += SaveChunk(Record) ? 1 : 0;
+	}
 
-	UE_LOG(LogTemp, Log, TEXT("Created chunk %s at world position %s (mesh component positioned at: %s)"), 
-		*ChunkID.ToString(), *NewChunk.WorldPosition.ToString(), *MeshComp->GetComponentLocation().ToString());
+	UE_LOG(LogTerraScape, Log, TEXT("TerraScape: Queued %d chunks for saving"), ChunksSaved);
 }
 
-void UTS_ChunkManager::DeleteChunk(const FIntVector& ChunkID)
+bool UTS_ChunkManager::SaveChunk(FTS_ChunkRecord& Record)
 {
-	if (!LoadedChunks.Contains(ChunkID))
+	// A save already in flight covers the current voxels, an edit since clears SaveSerial
+	if (!Record.HasVoxelData() || Record.SaveSerial != 0 || !(Record.bModified || (bPersistGeneratedChunks && !Record.bStored)))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Chunk %s does not exist"), *ChunkID.ToString());
-		return;
+		return false;
+	}
+
+	TSharedPtr<FTS_RegionStore, ESPMode::ThreadSafe> Store = GetRegionStore();
+	if (!Store.IsValid())
+	{
+		return false;
 	}
 
-	// Cancel any pending async mesh generation task
-	if (FAsyncTask<FTS_AsyncMeshGenerationTask>* AsyncTask = AsyncMeshTasks.FindRef(ChunkID))
+	// The save shares the storage like a mesh task does; an edit before it's written copies it first
+	Record.SaveSerial = Store->SaveChunkAsync(Record.ChunkID, Record.VoxelData, Record.UniformMaterialID, GetTaskThreadPool());
+	return true;
+}
+
+void UTS_ChunkManager::ProcessSaveResults()
+{
+	if (!RegionStore.IsValid())
 	{
-		AsyncTask->Cancel();
-		delete AsyncTask;
-		AsyncMeshTasks.Remove(ChunkID);
+		return;
 	}
 
-	// Remove mesh component if it exists
-	if (ChunkMeshes.Contains(ChunkID))
+	FTS_ChunkSaveResult SaveResult;
+	while (RegionStore->DequeueSaveResult(SaveResult))
 	{
-		UProceduralMeshComponent* MeshComp = ChunkMeshes[ChunkID];
-		if (MeshComp)
+		// Unloaded, or edited again since the save was queued
+		FTS_ChunkRecord* Record = ChunkRecords.Find(SaveResult.ChunkID);
+		if (!Record || Record->SaveSerial != SaveResult.Serial)
 		{
-			MeshComp->DestroyComponent();
+			continue;
 		}
-		ChunkMeshes.Remove(ChunkID);
-	}
 
-	// Remove chunk and its data
-	LoadedChunks.Remove(ChunkID);
-	ChunkVoxelData.Remove(ChunkID);
+		Record->SaveSerial = 0;
+		if (SaveResult.bSucceeded)
+		{
+			Record->bModified = false;
+			Record->bStored = true;
+		}
+		else
+		{
+			UE_LOG(LogTerraScape, Error, TEXT("TerraScape: Chunk %s could not be saved, keeping its changes for the next save"),
+				*SaveResult.ChunkID.ToString());
+		}
+	}
+}
 
-	UE_LOG(LogTemp, Log, TEXT("Deleted chunk %s"), *ChunkID.ToString());
+bool UTS_ChunkManager::IsValidChunkSize(int32 InChunkSize)
+{
+	return InChunkSize >= 1 && InChunkSize <= FTS_AsyncMeshGenerationTask::MaxGridSize;
 }
 
-bool UTS_ChunkManager::IsChunkLoaded(const FIntVector& ChunkID) const
+FString UTS_ChunkManager::GetWorldSaveDirectory(const FString& InWorldSaveName)
 {
-	return LoadedChunks.Contains(ChunkID);
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("TerraScape"), InWorldSaveName);
 }
 
-int32 UTS_ChunkManager::GetLoadedChunkCount() const
+void UTS_ChunkManager::ApplyWorldGenParameters()
 {
-	return LoadedChunks.Num();
+	if (WorldGenParameters && WorldGenerator)
+	{
+		WorldGenerator->SetWorldGenParameters(WorldGenParameters->Parameters);
+	}
 }
 
-TArray<FTS_Voxel> UTS_ChunkManager::GenerateTestVoxels(const FIntVector& ChunkID)
+uint32 UTS_ChunkManager::GetGeneratorFingerprint() const
 {
-	// Create simple test pattern for MVP - Minecraft-style terrain
-	TArray<FTS_Voxel> VoxelData;
-	const int32 TotalVoxels = ChunkSize * ChunkSize * ChunkSize;
-	VoxelData.Reserve(TotalVoxels);
+	uint32 Fingerprint = WorldGenerator ? WorldGenerator->GetParametersHash() : 0;
+	Fingerprint = HashCombine(Fingerprint, GetTypeHash(VoxelSize));
+	Fingerprint = HashCombine(Fingerprint, GetTypeHash(ChunkGap));
+	Fingerprint = HashCombine(Fingerprint, uint32(bUseProceduralGeneration));
+	return Fingerprint;
+}
 
-	for (int32 Z = 0; Z < ChunkSize; Z++)
+TSharedPtr<FTS_RegionStore, ESPMode::ThreadSafe> UTS_ChunkManager::GetRegionStore()
+{
+	if (!bEnablePersistence)
 	{
-		for (int32 Y = 0; Y < ChunkSize; Y++)
-		{
-			for (int32 X = 0; X < ChunkSize; X++)
-			{
-				FTS_Voxel NewVoxel;
-				
-				// Calculate world position of this voxel
-				FVector WorldPos = FVector(
-					ChunkID.X * ChunkSize + X,
-					ChunkID.Y * ChunkSize + Y,
-					ChunkID.Z * ChunkSize + Z
-				) * VoxelSize;
-				
-				// Create continuous terrain - simple ground plane at Z=0 with some thickness
-				float GroundHeight = 0.0f; // Ground level
-				float TerrainThickness = 4.0f * VoxelSize; // 4 voxels thick (400 units)
-				
-				// Simple continuous terrain - if we're at or below ground level, make it solid
-				if (WorldPos.Z <= GroundHeight && WorldPos.Z > (GroundHeight - TerrainThickness))
-				{
-					NewVoxel.MaterialID = 1; // Solid (ground)
-				}
-				else
-				{
-					NewVoxel.MaterialID = 0; // Air (sky)
-				}
+		return nullptr;
+	}
 
-				VoxelData.Add(NewVoxel);
-			}
-		}
+	if (!RegionStore.IsValid())
+	{
+		const FString Directory = GetWorldSaveDirectory(WorldSaveName);
+		RegionStore = MakeShared<FTS_RegionStore, ESPMode::ThreadSafe>(Directory, ChunkSize, GetGeneratorFingerprint(), RegionCompressionFormat);
+		UE_LOG(LogTerraScape, Log, TEXT("TerraScape: Storing chunks in %s"), *Directory);
 	}
+	return RegionStore;
+}
 
-	return VoxelData;
+void UTS_ChunkManager::CancelGenerationTask(FTS_ChunkRecord& Record)
+{
+	if (Record.GenerationTask)
+	{
+		RetireTask(Record.GenerationTask, RetiredGenerationTasks);
+		Record.GenerationTask = nullptr;
+		NumGenerationTasks--;
+	}
 }
 
-void UTS_ChunkManager::GenerateChunkMesh(const FIntVector& ChunkID)
+void UTS_ChunkManager::CancelMeshTask(FTS_ChunkRecord& Record)
 {
-	if (!ChunkVoxelData.Contains(ChunkID))
+	if (Record.MeshTask)
 	{
-		return;
+		RetireTask(Record.MeshTask, RetiredMeshTasks);
+		Record.MeshTask = nullptr;
+		NumMeshTasks--;
 	}
+}
 
-	// Create or get existing mesh component
-	UProceduralMeshComponent* MeshComp = nullptr;
-	if (ChunkMeshes.Contains(ChunkID))
+FTS_Voxel UTS_ChunkManager::GetVoxelAt(const FIntVector& ChunkID, int32 X, int32 Y, int32 Z) const
+{
+	if (X < 0 || X >= ChunkSize || Y < 0 || Y >= ChunkSize || Z < 0 || Z >= ChunkSize)
 	{
-		MeshComp = ChunkMeshes[ChunkID];
+		return FTS_Voxel(); // Return air voxel for out of bounds
 	}
-	else
+
+	// Uniform chunks keep a single material instead of a voxel array
+	const FTS_ChunkRecord* Record = ChunkRecords.Find(ChunkID);
+	if (!Record)
 	{
-		// Create new mesh component
-		MeshComp = NewObject<UProceduralMeshComponent>(GetOwner());
-		MeshComp->RegisterComponent();
-		ChunkMeshes.Add(ChunkID, MeshComp);
+		return FTS_Voxel(); // Return air voxel
 	}
+	return FTS_Voxel(GetRenderedMaterial(*Record, FIntVector(X, Y, Z), 0));
+}
 
-	// Generate mesh data with face culling
-	TArray<FVector> Vertices;
-	TArray<int32> Triangles;
-	TArray<FVector> Normals;
-	TArray<FVector2D> UVs;
-	TArray<FColor> Colors;
+bool UTS_ChunkManager::SetVoxelAt(const FIntVector& ChunkID, int32 X, int32 Y, int32 Z, int32 MaterialID)
+{
+	if (X < 0 || X >= ChunkSize || Y < 0 || Y >= ChunkSize || Z < 0 || Z >= ChunkSize)
+	{
+		return false;
+	}
 
-	const TArray<FTS_Voxel>& VoxelData = ChunkVoxelData[ChunkID];
-	// Calculate chunk world position using single source of truth
-	const FVector ChunkWorldPos = CalculateChunkWorldPosition(ChunkID);
-	
-	// Calculate LOD step size (for compatibility - this function uses LOD 0 by default)
-	int32 LODStep = 1;
-	float LODVoxelSize = VoxelSize * LODStep;
-
-	// Face directions for culling (these are normalized directions, not LOD-scaled)
-	const FVector FaceDirections[6] = {
-		FVector(1, 0, 0),   // Right
-		FVector(-1, 0, 0),  // Left
-		FVector(0, 1, 0),   // Forward
-		FVector(0, -1, 0),  // Back
-		FVector(0, 0, 1),   // Up
-		FVector(0, 0, -1)   // Down
-	};
+	const FTS_ChunkRecord* EditedRecord = ChunkRecords.Find(ChunkID);
+	if (!EditedRecord || !EditedRecord->HasVoxelData())
+	{
+		return false; // Not loaded or still generating
+	}
 
-	const FVector FaceNormals[6] = {
-		FVector(1, 0, 0),
-		FVector(-1, 0, 0),
-		FVector(0, 1, 0),
-		FVector(0, -1, 0),
-		FVector(0, 0, 1),
-		FVector(0, 0, -1)
-	};
+	// Every chunk whose range (widened by the apron) covers the voxel; only this chunk if the layout doesn't tile
+	const int32 StrideVoxels = GetChunkStrideVoxels();
+	const FIntVector WorldVoxel = ChunkID * StrideVoxels + FIntVector(X, Y, Z);
+	FIntVector MinChunk = ChunkID;
+	FIntVector MaxChunk = ChunkID;
+	if (StrideVoxels > 0)
+	{
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			MinChunk[Axis] = -FMath::FloorToInt(float(ChunkSize - WorldVoxel[Axis]) / StrideVoxels);
+			MaxChunk[Axis] = FMath::FloorToInt(float(WorldVoxel[Axis] + 1) / StrideVoxels);
+		}
+	}
 
-	// Generate faces only for visible voxels
-	for (int32 Z = 0; Z < ChunkSize; Z++)
+	// Copies of the voxel must all change or none, or the chunks would disagree where they overlap
+	TArray<FTS_ChunkRecord*, TInlineAllocator<8>> Copies;
+	TArray<FIntVector, TInlineAllocator<32>> ApronReaders;
+	for (int32 CZ = MinChunk.Z; CZ <= MaxChunk.Z; CZ++)
 	{
-		for (int32 Y = 0; Y < ChunkSize; Y++)
+		for (int32 CY = MinChunk.Y; CY <= MaxChunk.Y; CY++)
 		{
-			for (int32 X = 0; X < ChunkSize; X++)
+			for (int32 CX = MinChunk.X; CX <= MaxChunk.X; CX++)
 			{
-				// Only generate faces for solid voxels
-				if (!IsVoxelSolid(ChunkID, X, Y, Z))
+				const FIntVector OtherID(CX, CY, CZ);
+				FTS_ChunkRecord* Record = ChunkRecords.Find(OtherID);
+				if (!Record)
 				{
 					continue;
 				}
 
-				// Check each face direction
-				for (int32 FaceIndex = 0; FaceIndex < 6; FaceIndex++)
+				const FIntVector LocalPos = WorldVoxel - OtherID * StrideVoxels;
+				int32 NumAxesOutside = 0;
+				for (int32 Axis = 0; Axis < 3; Axis++)
 				{
-					FVector NeighborPos = FVector(X, Y, Z) + FaceDirections[FaceIndex];
-					
-					// Check if neighbor is air (outside chunk or empty)
-					bool bNeighborIsAir = false;
-					if (NeighborPos.X < 0 || NeighborPos.X >= ChunkSize ||
-						NeighborPos.Y < 0 || NeighborPos.Y >= ChunkSize ||
-						NeighborPos.Z < 0 || NeighborPos.Z >= ChunkSize)
-					{
-						// Outside chunk bounds - treat as air
-						bNeighborIsAir = true;
-					}
-					else
-					{
-						// Check if neighbor voxel is air
-						bNeighborIsAir = !IsVoxelSolid(ChunkID, NeighborPos.X, NeighborPos.Y, NeighborPos.Z);
-					}
+					NumAxesOutside += (LocalPos[Axis] < 0 || LocalPos[Axis] >= ChunkSize) ? 1 : 0;
+				}
 
-					// Only generate face if neighbor is air (face culling)
-					if (bNeighborIsAir)
+				if (NumAxesOutside == 0)
+				{
+					if (!Record->HasVoxelData())
 					{
-						// Generate quad for this face
-						FVector BasePos = ChunkWorldPos + FVector(X * VoxelSize, Y * VoxelSize, Z * VoxelSize);
-						FVector Normal = FaceNormals[FaceIndex];
-						
-						// Define quad vertices based on face direction (consistent counter-clockwise order)
-						TArray<FVector> QuadVertices;
-						QuadVertices.SetNum(4);
-						
-						if (FaceIndex == 0) // Right
-						{
-							QuadVertices[0] = BasePos + FVector(VoxelSize, 0, 0);
-							QuadVertices[1] = BasePos + FVector(VoxelSize, 0, VoxelSize);
-							QuadVertices[2] = BasePos + FVector(VoxelSize, VoxelSize, VoxelSize);
-							QuadVertices[3] = BasePos + FVector(VoxelSize, VoxelSize, 0);
-						}
-						else if (FaceIndex == 1) // Left
-						{
-							QuadVertices[0] = BasePos + FVector(0, VoxelSize, 0);
-							QuadVertices[1] = BasePos + FVector(0, VoxelSize, VoxelSize);
-							QuadVertices[2] = BasePos + FVector(0, 0, VoxelSize);
-							QuadVertices[3] = BasePos + FVector(0, 0, 0);
-						}
-						else if (FaceIndex == 2) // Forward
-						{
-							QuadVertices[0] = BasePos + FVector(0, VoxelSize, 0);
-							QuadVertices[1] = BasePos + FVector(VoxelSize, VoxelSize, 0);
-							QuadVertices[2] = BasePos + FVector(VoxelSize, VoxelSize, VoxelSize);
-							QuadVertices[3] = BasePos + FVector(0, VoxelSize, VoxelSize);
-						}
-						else if (FaceIndex == 3) // Back
-						{
-							QuadVertices[0] = BasePos + FVector(VoxelSize, 0, 0);
-							QuadVertices[1] = BasePos + FVector(0, 0, 0);
-							QuadVertices[2] = BasePos + FVector(0, 0, VoxelSize);
-							QuadVertices[3] = BasePos + FVector(VoxelSize, 0, VoxelSize);
-						}
-						else if (FaceIndex == 4) // Up
-						{
-							QuadVertices[0] = BasePos + FVector(0, 0, VoxelSize);
-							QuadVertices[1] = BasePos + FVector(0, VoxelSize, VoxelSize);
-							QuadVertices[2] = BasePos + FVector(VoxelSize, VoxelSize, VoxelSize);
-							QuadVertices[3] = BasePos + FVector(VoxelSize, 0, VoxelSize);
-						}
-						else if (FaceIndex == 5) // Down
-						{
-							QuadVertices[0] = BasePos + FVector(0, 0, 0);
-							QuadVertices[1] = BasePos + FVector(VoxelSize, 0, 0);
-							QuadVertices[2] = BasePos + FVector(VoxelSize, VoxelSize, 0);
-							QuadVertices[3] = BasePos + FVector(0, VoxelSize, 0);
-						}
-
-						// Add vertices
-						int32 StartIndex = Vertices.Num();
-						Vertices.Append(QuadVertices);
-						
-						// Add triangles (two triangles per quad) - counter-clockwise winding for outward normals
-						Triangles.Add(StartIndex);
-						Triangles.Add(StartIndex + 1);
-						Triangles.Add(StartIndex + 2);
-						
-						Triangles.Add(StartIndex);
-						Triangles.Add(StartIndex + 2);
-						Triangles.Add(StartIndex + 3);
-
-						// Add normals
-						for (int32 i = 0; i < 4; i++)
-						{
-							Normals.Add(Normal);
-						}
-
-						// Add UVs (simple mapping)
-						UVs.Add(FVector2D(0, 0));
-						UVs.Add(FVector2D(1, 0));
-						UVs.Add(FVector2D(1, 1));
-						UVs.Add(FVector2D(0, 1));
-
-						// Add vertex colors from material system
-						FColor VertexColor = FColor(0, 255, 0); // Default green
-						if (MaterialManager)
-						{
-							// Get color from material data (for now, use material ID 1 for grass)
-							VertexColor = MaterialManager->GetVertexColor(1);
-						}
-						
-						// Debug: Log the vertex color being used
-						if (X == 0 && Y == 0 && Z == 0 && FaceIndex == 0) // Log only for first voxel, first face
-						{
-							UE_LOG(LogTemp, Warning, TEXT("Using vertex color: R=%d, G=%d, B=%d, A=%d"), 
-								VertexColor.R, VertexColor.G, VertexColor.B, VertexColor.A);
-						}
-						
-						for (int32 i = 0; i < 4; i++)
-						{
-							Colors.Add(VertexColor);
-						}
+						return false;
 					}
+					Copies.Add(Record);
+				}
+				else if (NumAxesOutside == 1)
+				{
+					// Just outside one face: the voxel is in this chunk's apron
+					ApronReaders.Add(OtherID);
 				}
 			}
 		}
 	}
 
-	// Create the mesh
-	if (Vertices.Num() > 0)
+	// Remesh each changed copy and the chunks whose apron includes this voxel
+	bool bChanged = false;
+	for (FTS_ChunkRecord* Record : Copies)
 	{
-		MeshComp->CreateMeshSection(0, Vertices, Triangles, Normals, UVs, Colors, TArray<FProcMeshTangent>(), true);
-		
-		// Use material manager to get the appropriate material
-		UMaterialInterface* MaterialInterface = nullptr;
-		if (MaterialManager)
+		if (SetRecordVoxel(*Record, WorldVoxel - Record->ChunkID * StrideVoxels, MaterialID))
 		{
-			// Initialize MaterialManager with data table if not already done
-			if (MaterialDataTable && !MaterialManager->IsInitialized())
-			{
-				MaterialManager->InitializeMaterialDataTable(MaterialDataTable);
-				UE_LOG(LogTemp, Log, TEXT("TerraScape: Material data table initialized"));
-			}
-			
-			// For now, use material ID 1 (grass) for all chunks
-			MaterialInterface = MaterialManager->GetMaterialInterface(1);
-			UE_LOG(LogTemp, Warning, TEXT("MaterialManager found, MaterialInterface: %s"), 
-				MaterialInterface ? TEXT("Valid") : TEXT("NULL"));
+			MeshScheduler.Enqueue(Record->ChunkID);
+			bChanged = true;
 		}
-		else
+	}
+
+	if (bChanged)
+	{
+		for (const FIntVector& ReaderID : ApronReaders)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("MaterialManager is NULL!"));
+			const FTS_ChunkRecord* Reader = ChunkRecords.Find(ReaderID);
+			if (Reader && Reader->IsMeshable())
+			{
+				MeshScheduler.Enqueue(ReaderID);
+			}
 		}
-		
-		if (!MaterialDataTable)
+	}
+
+	return true;
+}
+
+bool UTS_ChunkManager::SetRecordVoxel(FTS_ChunkRecord& Record, const FIntVector& LocalPos, int32 MaterialID)
+{
+	if (!Record.VoxelData.IsValid())
+	{
+		if (Record.UniformMaterialID == MaterialID)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("TerraScape: No Material Data Table set! Please assign DT_VoxelMaterials in Blueprint."));
+			return false;
 		}
-		
-		if (MaterialInterface)
+
+		// Expand the single value into real storage so it can hold the edit
+		Record.VoxelData = MakeShared<FTS_ChunkVoxelStorage, ESPMode::ThreadSafe>(ChunkSize, Record.UniformMaterialID);
+		Record.VoxelData->BuildMips(bEnableLOD ? NumLODMipLevels : 0, LODReduction == ETS_LODReduction::AnySolid);
+		Record.bIsUniform = false;
+		Record.UniformMaterialID = 0;
+	}
+	else if (Record.VoxelData->Get(LocalPos.X, LocalPos.Y, LocalPos.Z) == MaterialID)
+	{
+		return false;
+	}
+	else if (!Record.VoxelData.IsUnique())
+	{
+		// A mesh task still reads this version: edit a copy and let the task finish with the old one
+		Record.VoxelData = MakeShared<FTS_ChunkVoxelStorage, ESPMode::ThreadSafe>(*Record.VoxelData);
+	}
+
+	Record.VoxelData->Set(LocalPos.X, LocalPos.Y, LocalPos.Z, MaterialID);
+	Record.bModified = true;
+	Record.SaveSerial = 0;
+	return true;
+}
+
+bool UTS_ChunkManager::IsVoxelSolid(const FIntVector& ChunkID, int32 X, int32 Y, int32 Z) const
+{
+	FTS_Voxel Voxel = GetVoxelAt(ChunkID, X, Y, Z);
+	return Voxel.IsSolid();
+}
+
+void UTS_ChunkManager::ProcessCompletedTasks()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UTS_ChunkManager::ProcessCompletedTasks);
+
+	// Only tasks that reported in are looked at, nothing is polled
+	FTS_ChunkTaskCompletion Completion;
+	while (CompletionQueue->Dequeue(Completion))
+	{
+		FTS_ChunkRecord* Record = ChunkRecords.Find(Completion.ChunkID);
+		if (Completion.TaskType == ETS_ChunkTaskType::VoxelGeneration)
 		{
-			// Use the material from the data table
-			MeshComp->SetMaterial(0, MaterialInterface);
-			UE_LOG(LogTemp, Warning, TEXT("Using material from data table"));
+			FAsyncTask<FTS_AsyncVoxelGenerationTask>* Task = Record ? Record->GenerationTask : nullptr;
+			if (!Task || Task->GetTask().Context.TaskSerial != Completion.TaskSerial)
+			{
+				// Superseded: it stopped early and its result is thrown away
+				if (RetiredGenerationTasks.RemoveAndCopyValue(Completion.TaskSerial, Task))
+				{
+					Task->EnsureCompletion();
+					delete Task;
+				}
+				continue;
+			}
+
+			// The notice is posted at the very end of DoWork, this only waits for the worker to return
+			Task->EnsureCompletion();
+			Record->GenerationTask = nullptr;
+			NumGenerationTasks--;
+			CompleteVoxelGeneration(*Record, Task->GetTask());
+			delete Task;
 		}
 		else
 		{
-			// No material specified in data table - use vertex colors only
-			// Create a basic material that supports vertex colors
-			UMaterial* BaseMaterial = LoadObject<UMaterial>(nullptr, TEXT("/Engine/BasicShapes/BasicShapeMaterial"));
-			if (BaseMaterial)
+			FAsyncTask<FTS_AsyncMeshGenerationTask>* Task = Record ? Record->MeshTask : nullptr;
+			if (!Task || Task->GetTask().Context.TaskSerial != Completion.TaskSerial)
 			{
-				UMaterialInstanceDynamic* DynamicMaterial = UMaterialInstanceDynamic::Create(BaseMaterial, this);
-				if (DynamicMaterial)
-				{
-					// Enable vertex color support
-					DynamicMaterial->SetScalarParameterValue(TEXT("UseVertexColors"), 1.0f);
-					MeshComp->SetMaterial(0, DynamicMaterial);
-					UE_LOG(LogTemp, Warning, TEXT("Using dynamic material with vertex colors"));
-				}
-				else
+				if (RetiredMeshTasks.RemoveAndCopyValue(Completion.TaskSerial, Task))
 				{
-					MeshComp->SetMaterial(0, BaseMaterial);
-					UE_LOG(LogTemp, Warning, TEXT("Using base material"));
+					Task->EnsureCompletion();
+					delete Task;
 				}
+				continue;
 			}
-			else
-			{
-				// Last resort: no material at all (should use vertex colors)
-				MeshComp->SetMaterial(0, nullptr);
-				UE_LOG(LogTemp, Warning, TEXT("No material - using vertex colors only"));
+
+			Task->EnsureCompletion();
+			Record->MeshTask = nullptr;
+			NumMeshTasks--;
+
+			// A newer mesh replaces one still waiting for upload; the task no longer holds a slot
+			DiscardReadyMesh(*Record);
+			Record->ReadyMeshTask = Task;
+			UploadScheduler.Enqueue(Record->ChunkID);
+		}
+	}
+
+	ProcessSaveResults();
+
+	// Start queued work in the slots that just freed up
+	ProcessPendingQueues();
+
+	UploadReadyMeshes();
+}
+
+void UTS_ChunkManager::UploadReadyMeshes()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UTS_ChunkManager::UploadReadyMeshes);
+
+	if (UploadScheduler.IsEmpty())
+	{
+		MeshUploadStats.PendingUploads = 0;
+		return;
+	}
+
+	// Upload the most urgent meshes until the time budget is spent, always at least one
+	UploadScheduler.SetView(GetSchedulerView());
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double BudgetSeconds = MeshUploadBudgetMs / 1000.0;
+	int32 Uploads = 0;
+	FIntVector ChunkID;
+	while (UploadScheduler.PopNext(ChunkID, [](const FIntVector&) { return true; }))
+	{
+		FTS_ChunkRecord* Record = ChunkRecords.Find(ChunkID);
+		if (Record && Record->ReadyMeshTask)
+		{
+			FAsyncTask<FTS_AsyncMeshGenerationTask>* Task = Record->ReadyMeshTask;
+			Record->ReadyMeshTask = nullptr;
+
+			// Built for a LOD the chunk has since left; its replacement is queued
+			if (Task->GetTask().GetLODLevel() != Record->LODLevel)
+			{
+				delete Task;
+				continue;
+			}
+
+			const double MeshStartTime = FPlatformTime::Seconds();
+			UploadChunkMesh(*Record, Task->GetTask());
+			delete Task;
+			Uploads++;
+
+			const float MeshUploadMs = (FPlatformTime::Seconds() - MeshStartTime) * 1000.0;
+			MeshUploadStats.PeakMeshUploadMs = FMath::Max(MeshUploadStats.PeakMeshUploadMs, MeshUploadMs);
+		}
+
+		if (BudgetSeconds > 0.0 && FPlatformTime::Seconds() - StartTime >= BudgetSeconds)
+		{
+			break;
+		}
+	}
+
+	const float UploadMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	MeshUploadStats.LastUploadMs = UploadMs;
+	MeshUploadStats.LastUploadCount = Uploads;
+	MeshUploadStats.PeakUploadMs = FMath::Max(MeshUploadStats.PeakUploadMs, UploadMs);
+	MeshUploadStats.PendingUploads = UploadScheduler.Num();
+	MeshUploadStats.TotalUploads += Uploads;
+
+	if (!UploadScheduler.IsEmpty())
+	{
+		UE_LOG(LogTerraScape, Verbose, TEXT("Uploaded %d meshes in %.2f ms, %d waiting for the next tick"),
+			Uploads, UploadMs, UploadScheduler.Num());
+	}
+}
+
+void UTS_ChunkManager::UploadChunkMesh(FTS_ChunkRecord& Record, FTS_AsyncMeshGenerationTask& TaskResult)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TerraScape_Upload);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UTS_ChunkManager::UploadChunkMesh);
+	const FIntVector& ChunkID = Record.ChunkID;
+
+	MeshMemoryBytes -= Record.MeshBytes;
+	Record.MeshBytes = 0;
+
+	// Apply the generated mesh data, creating the component on the first non-empty mesh
+	if (TaskResult.Vertices.Num() > 0)
+	{
+		if (UProceduralMeshComponent* MeshComp = GetOrCreateChunkMesh(Record))
+		{
+			{
+				// The section is created with collision, which cooks it here unless async cooking is on
+				SCOPE_CYCLE_COUNTER(STAT_TerraScape_Collision);
+				TRACE_CPUPROFILER_EVENT_SCOPE(UTS_ChunkManager::CreateChunkCollision);
+
+				// Collision-only results leave the render attribute arrays empty
+				MeshComp->CreateMeshSection(0, TaskResult.Vertices, TaskResult.Triangles, 
+					TaskResult.Normals, TaskResult.UVs, TaskResult.Colors, 
+					TArray<FProcMeshTangent>(), true);
+				MeshComp->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+			}
+
+			if (TaskResult.MaterialInterface)
+			{
+				MeshComp->SetMaterial(0, TaskResult.MaterialInterface);
+			}
+
+			Record.MeshBytes = TaskResult.Vertices.GetAllocatedSize() + TaskResult.Triangles.GetAllocatedSize()
+				+ TaskResult.Normals.GetAllocatedSize() + TaskResult.UVs.GetAllocatedSize() + TaskResult.Colors.GetAllocatedSize();
+			MeshMemoryBytes += Record.MeshBytes;
+			
+			UE_LOG(LogTerraScape, Verbose, TEXT("Async mesh generation completed for chunk %s (%d vertices, %.2f ms)"), 
+				*ChunkID.ToString(), TaskResult.Vertices.Num(), TaskResult.BuildTimeMs);
+		}
+	}
+	else if (Record.Mesh)
+	{
+		// Remeshed to nothing (e.g. a coarser LOD), drop the old section
+		Record.Mesh->ClearMeshSection(0);
+	}
+
+	// Neighbours sampled this chunk at the LOD it had on screen, or at its target before the first mesh;
+	// those that don't match the new mesh would leave a crack against it
+	Record.RenderedLODLevel = TaskResult.GetLODLevel();
+	RemeshNeighborsOfChunk(Record);
+
+	// First mesh of the chunk: it's now as loaded as it gets
+	if (Record.RequestTime > 0.0)
+	{
+		const float LatencyMs = (FPlatformTime::Seconds() - Record.RequestTime) * 1000.0;
+		Record.RequestTime = 0.0;
+		MeshUploadStats.LastChunkLatencyMs = LatencyMs;
+		MeshUploadStats.PeakChunkLatencyMs = FMath::Max(MeshUploadStats.PeakChunkLatencyMs, LatencyMs);
+		SET_FLOAT_STAT(STAT_TerraScape_ChunkLatency, LatencyMs);
+	}
+}
+
+void UTS_ChunkManager::DiscardReadyMesh(FTS_ChunkRecord& Record)
+{
+	if (Record.ReadyMeshTask)
+	{
+		delete Record.ReadyMeshTask;
+		Record.ReadyMeshTask = nullptr;
+	}
+	UploadScheduler.Remove(Record.ChunkID);
+}
+
+FTS_MeshUploadStats UTS_ChunkManager::GetMeshUploadStats() const
+{
+	return MeshUploadStats;
+}
+
+void UTS_ChunkManager::ResetMeshUploadStats()
+{
+	MeshUploadStats = FTS_MeshUploadStats();
+	MeshUploadStats.PendingUploads = UploadScheduler.Num();
+}
+
+void UTS_ChunkManager::CompleteVoxelGeneration(FTS_ChunkRecord& Record, FTS_AsyncVoxelGenerationTask& TaskResult)
+{
+	// Store the generated voxels for the chunk (the task owns no other state we need)
+	const FIntVector& ChunkID = Record.ChunkID;
+	Record.bStored = TaskResult.bLoadedFromRegion && !TaskResult.bLoadedUnsaved;
+	Record.bModified = TaskResult.bLoadedUnsaved;
+	if (TaskResult.bIsUniform)
+	{
+		// All air or all one material: keep the single value, no voxel array
+		Record.bIsUniform = true;
+		Record.UniformMaterialID = TaskResult.UniformMaterialID;
+		Record.RequestTime = 0.0;
+
+		// A solid one still needs walls where a neighbour is open, e.g. a cave reaching the border
+		if (Record.IsMeshable())
+		{
+			MeshScheduler.Enqueue(ChunkID);
+		}
+
+		UE_LOG(LogTerraScape, Verbose, TEXT("Chunk %s is uniform (material %d), skipping voxel storage and meshing"), 
+			*ChunkID.ToString(), TaskResult.UniformMaterialID);
+	}
+	else
+	{
+		UE_LOG(LogTerraScape, Verbose, TEXT("Chunk %s: %d solid voxels out of %d total, %d materials at %d bits (%d bytes), VoxelSize=%.1f, ChunkSize=%d"), 
+			*ChunkID.ToString(), TaskResult.SolidVoxelCount, TaskResult.VoxelStorage.Num(), 
+			TaskResult.VoxelStorage.GetPalette().Num(), TaskResult.VoxelStorage.GetBitsPerIndex(), 
+			static_cast<int32>(TaskResult.VoxelStorage.GetAllocatedSize()), VoxelSize, ChunkSize);
+
+		Record.VoxelData = MakeShared<FTS_ChunkVoxelStorage, ESPMode::ThreadSafe>(MoveTemp(TaskResult.VoxelStorage));
+		MeshScheduler.Enqueue(ChunkID);
+	}
+
+	// Neighbours meshed before this chunk had data treated its border as air
+	RemeshNeighborsOfChunk(Record);
+}
+
+uint32 UTS_ChunkManager::InitTaskContext(FTS_ChunkTaskContext& Context)
+{
+	Context.Queue = CompletionQueue;
+	Context.AffinityMask = WorkerPool.IsRunning() ? WorkerPool.GetAffinityMask() : 0;
+	Context.TaskSerial = NextTaskSerial++;
+	if (NextTaskSerial == 0)
+	{
+		NextTaskSerial = 1;
+	}
+	return Context.TaskSerial;
+}
+
+UProceduralMeshComponent* UTS_ChunkManager::GetOrCreateChunkMesh(FTS_ChunkRecord& Record)
+{
+	if (Record.Mesh)
+	{
+		return Record.Mesh;
+	}
+
+	if (!GetOwner())
+	{
+		return nullptr;
+	}
+
+	// Reused components are already registered and attached, they only move
+	UProceduralMeshComponent* MeshComp = AcquireMeshComponent();
+	MeshComp->SetWorldLocation(Record.WorldPosition);
+	MeshComp->SetVisibility(!IsCollisionOnly());
+
+	Record.Mesh = MeshComp;
+	NumChunkMeshes++;
+	MeshComponentHighWaterMark = FMath::Max(MeshComponentHighWaterMark, NumChunkMeshes + MeshComponentPool.Num());
+	return MeshComp;
+}
+
+UProceduralMeshComponent* UTS_ChunkManager::AcquireMeshComponent()
+{
+	while (MeshComponentPool.Num() > 0)
+	{
+		UProceduralMeshComponent* MeshComp = MeshComponentPool.Pop(EAllowShrinking::No);
+		if (IsValid(MeshComp))
+		{
+			return MeshComp;
+		}
+	}
+	return CreatePooledMeshComponent();
+}
+
+void UTS_ChunkManager::ReleaseMeshComponent(UProceduralMeshComponent* MeshComp)
+{
+	if (!IsValid(MeshComp))
+	{
+		return;
+	}
+
+	if (MeshComponentPool.Num() >= MeshComponentPoolMaxSize)
+	{
+		MeshComp->DestroyComponent();
+		return;
+	}
+
+	// Drop the mesh, render state and physics body, keep the UObject and its registration
+	MeshComp->ClearAllMeshSections();
+	MeshComp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	MeshComp->SetVisibility(false);
+	MeshComp->SetMaterial(0, nullptr);
+	MeshComponentPool.Add(MeshComp);
+}
+
+UProceduralMeshComponent* UTS_ChunkManager::CreatePooledMeshComponent()
+{
+	UProceduralMeshComponent* MeshComp = NewObject<UProceduralMeshComponent>(this);
+	if (IsCollisionOnly())
+	{
+		// Nothing to draw, and cooking the collision shouldn't stall the game thread
+		MeshComp->SetCastShadow(false);
+		MeshComp->bUseAsyncCooking = true;
+	}
+	MeshComp->SetVisibility(false);
+	MeshComp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	MeshComp->RegisterComponent();
+	if (AActor* Owner = GetOwner())
+	{
+		MeshComp->AttachToComponent(Owner->GetRootComponent(), FAttachmentTransformRules::KeepWorldTransform);
+	}
+	return MeshComp;
+}
+
+void UTS_ChunkManager::WarmUpMeshComponentPool()
+{
+	if (!GetOwner())
+	{
+		return;
+	}
+
+	const int32 NumToCreate = FMath::Min(MeshComponentPoolWarmUp, MeshComponentPoolMaxSize) - MeshComponentPool.Num();
+	for (int32 Index = 0; Index < NumToCreate; Index++)
+	{
+		MeshComponentPool.Add(CreatePooledMeshComponent());
+	}
+	MeshComponentHighWaterMark = FMath::Max(MeshComponentHighWaterMark, NumChunkMeshes + MeshComponentPool.Num());
+
+	if (NumToCreate > 0)
+	{
+		UE_LOG(LogTerraScape, Log, TEXT("TerraScape: Warmed up %d pooled mesh components"), NumToCreate);
+	}
+}
+
+void UTS_ChunkManager::EmptyMeshComponentPool()
+{
+	for (UProceduralMeshComponent* MeshComp : MeshComponentPool)
+	{
+		if (IsValid(MeshComp))
+		{
+			MeshComp->DestroyComponent();
+		}
+	}
+	MeshComponentPool.Empty();
+}
+
+int32 UTS_ChunkManager::GetPooledMeshComponentCount() const
+{
+	return MeshComponentPool.Num();
+}
+
+int32 UTS_ChunkManager::GetMeshComponentHighWaterMark() const
+{
+	return MeshComponentHighWaterMark;
+}
+
+void UTS_ChunkManager::StartVoxelGeneration(const FIntVector& ChunkID)
+{
+	FTS_ChunkRecord* Record = ChunkRecords.Find(ChunkID);
+	if (!Record || Record->GenerationTask)
+	{
+		return;
+	}
+
+	FAsyncTask<FTS_AsyncVoxelGenerationTask>* AsyncTask = new FAsyncTask<FTS_AsyncVoxelGenerationTask>(
+		ChunkID, ChunkSize, VoxelSize, Record->WorldPosition, WorldGenerator, bUseProceduralGeneration,
+		bEnableLOD ? NumLODMipLevels : 0, LODReduction, GetRegionStore());
+	FQueuedThreadPool* ThreadPool = GetTaskThreadPool();
+	InitTaskContext(AsyncTask->GetTask().Context);
+
+	AsyncTask->StartBackgroundTask(ThreadPool);
+	Record->GenerationTask = AsyncTask;
+	NumGenerationTasks++;
+
+	UE_LOG(LogTerraScape, Verbose, TEXT("Started async voxel generation for chunk %s (%d/%d tasks)"), 
+		*ChunkID.ToString(), GetNumAsyncTasks(), GetMaxConcurrentAsyncTasks());
+}
+
+void UTS_ChunkManager::StartMeshGeneration(const FIntVector& ChunkID)
+{
+	FTS_ChunkRecord* Record = ChunkRecords.Find(ChunkID);
+	if (!Record || !Record->IsMeshable())
+	{
+		return;
+	}
+
+	// A superseded mesh task would report a stale mesh, stop it without waiting
+	CancelMeshTask(*Record);
+
+	// Get LOD level for this chunk and remember it so UpdateChunkLOD doesn't remesh immediately
+	// (uniform chunks look the same at every LOD and neighbours sample them at 0)
+	const int32 LODLevel = Record->bIsUniform ? 0 : GetChunkLODLevel(ChunkID);
+	Record->LODLevel = LODLevel;
+
+	// Copy the border from the neighbours so faces against loaded chunks are culled
+	FTS_ChunkApron Apron = BuildChunkApron(*Record);
+	Record->ApronSignature = Apron.GetSignature();
+	Record->bHasApronSignature = true;
+
+	// The task shares the voxel storage rather than copying it
+	TSharedPtr<const FTS_ChunkVoxelStorage, ESPMode::ThreadSafe> VoxelData = Record->VoxelData;
+	if (Record->bIsUniform)
+	{
+		// A solid uniform chunk only shows its border where a loaded neighbour is open; sides that aren't
+		// loaded stay closed, so chunks deep underground don't build a mesh at the edge of the streamed area
+		bool bHasOpenFace = false;
+		for (int32 FaceIndex = 0; FaceIndex < 6; FaceIndex++)
+		{
+			TArray<int32>& Face = Apron.Faces[FaceIndex];
+			if (Face.Num() == 0)
+			{
+				Face.Init(Record->UniformMaterialID, ChunkSize * ChunkSize);
+			}
+			else if (!bHasOpenFace)
+			{
+				bHasOpenFace = Face.ContainsByPredicate([](int32 MaterialID) { return MaterialID <= 0; });
+			}
+		}
+
+		if (!bHasOpenFace)
+		{
+			DiscardReadyMesh(*Record);
+			if (Record->Mesh)
+			{
+				Record->Mesh->ClearMeshSection(0);
+				MeshMemoryBytes -= Record->MeshBytes;
+				Record->MeshBytes = 0;
+			}
+			return;
+		}
+
+		// Single palette entry, so the filled storage is a few bits per voxel and only lives for the task
+		VoxelData = MakeShared<FTS_ChunkVoxelStorage, ESPMode::ThreadSafe>(ChunkSize, Record->UniformMaterialID);
+	}
+
+	// Create async task for mesh generation
+	FAsyncTask<FTS_AsyncMeshGenerationTask>* AsyncTask = new FAsyncTask<FTS_AsyncMeshGenerationTask>(
+		ChunkID, VoxelData.ToSharedRef(), ChunkSize, VoxelSize, Record->WorldPosition, MaterialManager, LODLevel, MeshingMode, MoveTemp(Apron),
+		IsCollisionOnly());
+	FQueuedThreadPool* ThreadPool = GetTaskThreadPool();
+	InitTaskContext(AsyncTask->GetTask().Context);
+
+	AsyncTask->StartBackgroundTask(ThreadPool);
+	Record->MeshTask = AsyncTask;
+	NumMeshTasks++;
+
+	UE_LOG(LogTerraScape, Verbose, TEXT("Started async mesh generation for chunk %s (%d/%d tasks)"), 
+		*ChunkID.ToString(), GetNumAsyncTasks(), GetMaxConcurrentAsyncTasks());
+}
+
+void UTS_ChunkManager::ProcessPendingQueues()
+{
+	// Rank queued work around the observer; only re-sorts when they moved or turned enough
+	const FTS_ChunkSchedulerView View = GetSchedulerView();
+	MeshScheduler.SetView(View);
+	GenerationScheduler.SetView(View);
+
+	// Meshing first: those chunks already have voxel data and are closest to being visible
+	// A remesh requested while a mesh task is running waits for it, the running task has a stale apron
+	FIntVector QueuedChunkID;
+	auto HasNoMeshTask = [this](const FIntVector& ChunkID)
+	{
+		const FTS_ChunkRecord* Record = ChunkRecords.Find(ChunkID);
+		return !Record || !Record->MeshTask;
+	};
+	while (GetNumAsyncTasks() < GetMaxConcurrentAsyncTasks() && MeshScheduler.PopNext(QueuedChunkID, HasNoMeshTask))
+	{
+		UE_LOG(LogTerraScape, Verbose, TEXT("Processing queued chunk %s from pending mesh queue"), *QueuedChunkID.ToString());
+
+		// Start mesh generation for the queued chunk (unloaded chunks are skipped)
+		StartMeshGeneration(QueuedChunkID);
+	}
+
+	auto HasNoGenerationTask = [this](const FIntVector& ChunkID)
+	{
+		const FTS_ChunkRecord* Record = ChunkRecords.Find(ChunkID);
+		return !Record || !Record->GenerationTask;
+	};
+	while (GetNumAsyncTasks() < GetMaxConcurrentAsyncTasks() && GenerationScheduler.PopNext(QueuedChunkID, HasNoGenerationTask))
+	{
+		UE_LOG(LogTerraScape, Verbose, TEXT("Processing queued chunk %s from pending generation queue"), *QueuedChunkID.ToString());
+
+		StartVoxelGeneration(QueuedChunkID);
+	}
+}
+
+FTS_ChunkApron UTS_ChunkManager::BuildChunkApron(const FTS_ChunkRecord& Record) const
+{
+	FTS_ChunkApron Apron;
+	const int32 StrideVoxels = GetChunkStrideVoxels();
+
+	for (int32 FaceIndex = 0; FaceIndex < 6; FaceIndex++)
+	{
+		const FIntVector Direction = FTS_ChunkFaces::GetDirection(FaceIndex);
+		const FTS_ChunkRecord* Neighbor = ChunkRecords.GetNeighbor(Record, FaceIndex);
+		if (!Neighbor || !Neighbor->HasVoxelData())
+		{
+			continue; // Not loaded yet - its side stays air until it arrives
+		}
+
+		const int32 NeighborLOD = GetRenderedLODLevel(*Neighbor);
+		Apron.LoadedMask |= 1 << FaceIndex;
+		Apron.FaceLODs[FaceIndex] = static_cast<uint8>(NeighborLOD);
+		TArray<int32>& Face = Apron.Faces[FaceIndex];
+		Face.SetNumUninitialized(ChunkSize * ChunkSize);
+
+		const int32 Axis = FaceIndex / 2;
+		const int32 AxisU = (Axis == 0) ? 1 : 0;
+		const int32 AxisV = (Axis == 2) ? 1 : 2;
+
+		for (int32 V = 0; V < ChunkSize; V++)
+		{
+			for (int32 U = 0; U < ChunkSize; U++)
+			{
+				// Voxel just outside this chunk, in the neighbour's local coordinates
+				FIntVector LocalPos;
+				LocalPos[Axis] = (Direction[Axis] > 0) ? ChunkSize : -1;
+				LocalPos[AxisU] = U;
+				LocalPos[AxisV] = V;
+				LocalPos -= Direction * StrideVoxels;
+
+				Face[U + V * ChunkSize] = GetRenderedMaterial(*Neighbor, LocalPos, NeighborLOD);
+			}
+		}
+	}
+
+	return Apron;
+}
+
+void UTS_ChunkManager::RemeshNeighborsOfChunk(const FTS_ChunkRecord& Record)
+{
+	const bool bChunkHasData = Record.HasVoxelData();
+	const uint32 ChunkLOD = bChunkHasData ? static_cast<uint32>(GetRenderedLODLevel(Record)) : 0;
+
+	for (int32 FaceIndex = 0; FaceIndex < 6; FaceIndex++)
+	{
+		// Only meshed chunks care (air chunks have no mesh); not meshed yet means it will
+		// sample the current state when it is
+		const FTS_ChunkRecord* Neighbor = ChunkRecords.GetNeighbor(Record, FaceIndex);
+		if (!Neighbor || !Neighbor->IsMeshable() || !Neighbor->bHasApronSignature)
+		{
+			continue;
+		}
+
+		// The neighbour sees this chunk across its opposite face
+		const int32 NeighborFace = FaceIndex ^ 1;
+		const bool bBuiltWithChunk = (Neighbor->ApronSignature & (1 << NeighborFace)) != 0;
+		const uint32 BuiltWithLOD = (Neighbor->ApronSignature >> (8 + NeighborFace * 2)) & 3;
+
+		// Meshed against the same state: nothing to do
+		if (bBuiltWithChunk == bChunkHasData && BuiltWithLOD == ChunkLOD)
+		{
+			continue;
+		}
+
+		MeshScheduler.Enqueue(Neighbor->ChunkID);
+		UE_LOG(LogTerraScape, Verbose, TEXT("Queued chunk %s for remesh, neighbour %s %s"),
+			*Neighbor->ChunkID.ToString(), *Record.ChunkID.ToString(),
+			bBuiltWithChunk != bChunkHasData ? (bChunkHasData ? TEXT("loaded") : TEXT("unloaded")) : TEXT("changed LOD"));
+	}
+}
+
+int32 UTS_ChunkManager::GetRenderedLODLevel(const FTS_ChunkRecord& Record) const
+{
+	if (Record.bIsUniform)
+	{
+		return 0;
+	}
+	if (Record.RenderedLODLevel != INDEX_NONE)
+	{
+		return FMath::Clamp(Record.RenderedLODLevel, 0, 3);
+	}
+	return FMath::Clamp(Record.LODLevel != INDEX_NONE ? Record.LODLevel : GetChunkLODLevel(Record.ChunkID), 0, 3);
+}
+
+int32 UTS_ChunkManager::GetRenderedMaterial(const FTS_ChunkRecord& Record, const FIntVector& LocalPos, int32 LODLevel) const
+{
+	if (LocalPos.X < 0 || LocalPos.X >= ChunkSize || LocalPos.Y < 0 || LocalPos.Y >= ChunkSize || LocalPos.Z < 0 || LocalPos.Z >= ChunkSize)
+	{
+		return 0;
+	}
+
+	// Uniform chunks keep a single material instead of a voxel array
+	if (Record.bIsUniform)
+	{
+		return Record.UniformMaterialID;
+	}
+
+	const FTS_ChunkVoxelStorage* VoxelData = Record.VoxelData.Get();
+	if (!VoxelData || VoxelData->GetChunkSize() != ChunkSize)
+	{
+		return 0;
+	}
+
+	if (LODLevel == 0)
+	{
+		return VoxelData->Get(LocalPos.X, LocalPos.Y, LocalPos.Z);
+	}
+
+	// Same cell the chunk's own mesh task uses: its mip, or the first voxel of the cell without mips
+	const FTS_ChunkVoxelStorage* Mip = VoxelData->GetMip(LODLevel);
+	const int32 MipSize = ChunkSize >> LODLevel;
+	if (Mip && Mip->GetChunkSize() == MipSize)
+	{
+		return Mip->Get(FMath::Min(LocalPos.X >> LODLevel, MipSize - 1), FMath::Min(LocalPos.Y >> LODLevel, MipSize - 1),
+			FMath::Min(LocalPos.Z >> LODLevel, MipSize - 1));
+	}
+	return VoxelData->Get((LocalPos.X >> LODLevel) << LODLevel, (LocalPos.Y >> LODLevel) << LODLevel, (LocalPos.Z >> LODLevel) << LODLevel);
+}
+
+int32 UTS_ChunkManager::GetChunkStrideVoxels() const
+{
+	return FMath::RoundToInt((ChunkSize * VoxelSize + ChunkGap) / VoxelSize);
+}
+
+FIntVector UTS_ChunkManager::GetChunkIDAtLocation(const FVector& WorldLocation) const
+{
+	const float ChunkWorldSize = ChunkSize * VoxelSize;
+	const float ChunkStride = ChunkWorldSize + ChunkGap;
+	if (ChunkStride <= 0.0f)
+	{
+		return FIntVector::ZeroValue;
+	}
+
+	// Chunk centres sit at ID * Stride + ChunkWorldSize / 2
+	const FVector Cell = (WorldLocation - FVector(ChunkWorldSize * 0.5f)) / ChunkStride;
+	return FIntVector(FMath::RoundToInt(Cell.X), FMath::RoundToInt(Cell.Y), FMath::RoundToInt(Cell.Z));
+}
+
+void UTS_ChunkManager::RegisterStreamingObserver(AActor* Actor, int32 RadiusXY, int32 RadiusZ, float PriorityWeight)
+{
+	if (!Actor)
+	{
+		return;
+	}
+
+	FTS_StreamingObserver* Observer = StreamingObservers.FindByPredicate([Actor](const FTS_StreamingObserver& Existing)
+	{
+		return Existing.Actor.Get() == Actor;
+	});
+	if (!Observer)
+	{
+		Observer = &StreamingObservers.AddDefaulted_GetRef();
+		Observer->Actor = Actor;
+	}
+
+	Observer->RadiusXY = RadiusXY;
+	Observer->RadiusZ = RadiusZ;
+	Observer->PriorityWeight = PriorityWeight;
+
+	UE_LOG(LogTerraScape, Log, TEXT("Registered streaming observer %s (radius %d/%d, weight %.2f), %d observers"), 
+		*Actor->GetName(), RadiusXY, RadiusZ, PriorityWeight, StreamingObservers.Num());
+}
+
+void UTS_ChunkManager::UnregisterStreamingObserver(AActor* Actor)
+{
+	const int32 NumRemoved = StreamingObservers.RemoveAll([Actor](const FTS_StreamingObserver& Existing)
+	{
+		return Existing.Actor.Get() == Actor;
+	});
+
+	if (NumRemoved > 0)
+	{
+		UE_LOG(LogTerraScape, Log, TEXT("Unregistered streaming observer %s, %d observers"), 
+			Actor ? *Actor->GetName() : TEXT("None"), StreamingObservers.Num());
+	}
+}
+
+bool UTS_ChunkManager::IsStreamingObserver(const AActor* Actor) const
+{
+	return StreamingObservers.ContainsByPredicate([Actor](const FTS_StreamingObserver& Existing)
+	{
+		return Existing.Actor.Get() == Actor;
+	});
+}
+
+bool UTS_ChunkManager::IsCollisionOnly() const
+{
+	switch (MeshContent)
+	{
+		case ETS_ChunkMeshContent::CollisionOnly: return true;
+		case ETS_ChunkMeshContent::RenderAndCollision: return false;
+		default: return IsNetMode(NM_DedicatedServer);
+	}
+}
+
+void UTS_ChunkManager::UpdateStreaming()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UTS_ChunkManager::UpdateStreaming);
+
+	if (!bEnableStreaming)
+	{
+		return;
+	}
+
+	// PlayerReference streams with the manager's own radii unless it was registered explicitly
+	PlayerObserver.Actor = PlayerReference;
+	PlayerObserver.RadiusXY = StreamingRadiusXY;
+	PlayerObserver.RadiusZ = StreamingRadiusZ;
+
+	TArray<FTS_StreamingObserver*, TInlineAllocator<64>> Observers;
+	for (FTS_StreamingObserver& Observer : StreamingObservers)
+	{
+		if (Observer.Actor.IsValid())
+		{
+			Observers.Add(&Observer);
+		}
+	}
+	if (PlayerReference && !IsStreamingObserver(PlayerReference))
+	{
+		Observers.Add(&PlayerObserver);
+	}
+
+	// Recentre observers that crossed into another chunk or changed radius
+	bool bVolumeChanged = Observers.Num() != NumStreamingObservers;
+	NumStreamingObservers = Observers.Num();
+	for (FTS_StreamingObserver* Observer : Observers)
+	{
+		const FIntPoint Radius(FMath::Max(0, Observer->RadiusXY), FMath::Max(0, Observer->RadiusZ));
+		const FIntVector Center = GetChunkIDAtLocation(Observer->Actor->GetActorLocation());
+		if (!Observer->bHasStreamingCenter || Center != Observer->StreamingCenter || Radius != Observer->StreamingRadius)
+		{
+			Observer->StreamingCenter = Center;
+			Observer->StreamingRadius = Radius;
+			Observer->bHasStreamingCenter = true;
+			Observer->LoadCursor = 0;
+			bVolumeChanged = true;
+		}
+	}
+
+	if (Observers.Num() == 0)
+	{
+		return; // Nobody to stream for: keep what's loaded
+	}
+
+	// Chunks outside every observer's volume plus the hysteresis margin, farthest at the end
+	if (bVolumeChanged || bStreamingUnloadListDirty)
+	{
+		bStreamingUnloadListDirty = false;
+		// Ranked by the nearest observer, so a chunk just outside one player's margin stays behind truly distant ones
+		TArray<TPair<int64, FIntVector>> UnloadCandidates;
+		for (const FTS_ChunkRecord& Record : ChunkRecords)
+		{
+			int64 NearestDistanceSq = 0;
+			if (!IsInStreamingVolume(Record.ChunkID, Observers, StreamingHysteresis, &NearestDistanceSq))
+			{
+				UnloadCandidates.Emplace(NearestDistanceSq, Record.ChunkID);
+			}
+		}
+		UnloadCandidates.Sort([](const TPair<int64, FIntVector>& A, const TPair<int64, FIntVector>& B)
+		{
+			return A.Key < B.Key;
+		});
+
+		StreamingUnloadList.Reset(UnloadCandidates.Num());
+		for (const TPair<int64, FIntVector>& Candidate : UnloadCandidates)
+		{
+			StreamingUnloadList.Add(Candidate.Value);
+		}
+	}
+
+	// Unload first so resident memory stays bounded while travelling
+	int32 ChunksUnloaded = 0;
+	while (StreamingUnloadList.Num() > 0 && ChunksUnloaded < MaxChunkUnloadsPerTick)
+	{
+		const FIntVector ChunkID = StreamingUnloadList.Pop(EAllowShrinking::No);
+		if (ChunkRecords.Contains(ChunkID) && !IsInStreamingVolume(ChunkID, Observers, StreamingHysteresis))
+		{
+			DeleteChunk(ChunkID);
+			ChunksUnloaded++;
+		}
+	}
+
+	// Then request missing chunks, taking turns between observers so nobody starves; chunks already
+	// loaded for another observer are skipped, so overlapping volumes generate shared chunks once
+	const int32 MaxQueuedGeneration = GetMaxConcurrentAsyncTasks() * 4;
+	int32 ChunksRequested = 0;
+	bool bHasMoreToLoad = true;
+	while (bHasMoreToLoad && ChunksRequested < MaxChunkLoadsPerTick && GenerationScheduler.Num() < MaxQueuedGeneration)
+	{
+		bHasMoreToLoad = false;
+		for (FTS_StreamingObserver* Observer : Observers)
+		{
+			const TArray<FIntVector>& Offsets = GetStreamingOffsets(Observer->StreamingRadius);
+			while (Observer->LoadCursor < Offsets.Num())
+			{
+				const FIntVector ChunkID = Observer->StreamingCenter + Offsets[Observer->LoadCursor++];
+				if (!ChunkRecords.Contains(ChunkID))
+				{
+					CreateChunk(ChunkID);
+					ChunksRequested++;
+					break;
+				}
+			}
+
+			bHasMoreToLoad |= Observer->LoadCursor < Offsets.Num();
+			if (ChunksRequested >= MaxChunkLoadsPerTick || GenerationScheduler.Num() >= MaxQueuedGeneration)
+			{
+				break;
+			}
+		}
+	}
+
+	// Everything requested above is inside a volume, the unload list is still complete
+	bStreamingUnloadListDirty = false;
+
+	if (ChunksRequested > 0 || ChunksUnloaded > 0)
+	{
+		UE_LOG(LogTerraScape, Verbose, TEXT("Streaming for %d observers: requested %d, unloaded %d (%d left to unload)"), 
+			Observers.Num(), ChunksRequested, ChunksUnloaded, StreamingUnloadList.Num());
+	}
+}
+
+const TArray<FIntVector>& UTS_ChunkManager::GetStreamingOffsets(const FIntPoint& Radius)
+{
+	TArray<FIntVector>& Offsets = StreamingOffsetsByRadius.FindOrAdd(Radius);
+	if (Offsets.Num() > 0)
+	{
+		return Offsets;
+	}
+
+	// Every offset in the cylinder, nearest first
+	for (int32 Z = -Radius.Y; Z <= Radius.Y; Z++)
+	{
+		for (int32 Y = -Radius.X; Y <= Radius.X; Y++)
+		{
+			for (int32 X = -Radius.X; X <= Radius.X; X++)
+			{
+				if (X * X + Y * Y <= Radius.X * Radius.X)
+				{
+					Offsets.Add(FIntVector(X, Y, Z));
+				}
+			}
+		}
+	}
+	Offsets.Sort([](const FIntVector& A, const FIntVector& B)
+	{
+		return A.X * A.X + A.Y * A.Y + A.Z * A.Z < B.X * B.X + B.Y * B.Y + B.Z * B.Z;
+	});
+	return Offsets;
+}
+
+void UTS_ChunkManager::RestartStreamingAround(const FIntVector& ChunkID)
+{
+	auto Restart = [this, &ChunkID](FTS_StreamingObserver& Observer)
+	{
+		FTS_StreamingObserver* const ObserverPtr = &Observer;
+		if (Observer.bHasStreamingCenter && IsInStreamingVolume(ChunkID, MakeArrayView(&ObserverPtr, 1), 0))
+		{
+			Observer.LoadCursor = 0;
+		}
+	};
+
+	for (FTS_StreamingObserver& Observer : StreamingObservers)
+	{
+		Restart(Observer);
+	}
+	Restart(PlayerObserver);
+}
+
+bool UTS_ChunkManager::IsInStreamingVolume(const FIntVector& ChunkID, TArrayView<FTS_StreamingObserver* const> Observers, int32 Margin,
+	int64* OutNearestDistanceSq) const
+{
+	if (OutNearestDistanceSq)
+	{
+		*OutNearestDistanceSq = MAX_int64;
+	}
+
+	for (const FTS_StreamingObserver* Observer : Observers)
+	{
+		const FIntVector Offset = ChunkID - Observer->StreamingCenter;
+		if (OutNearestDistanceSq)
+		{
+			const int64 DistanceSq = int64(Offset.X) * Offset.X + int64(Offset.Y) * Offset.Y + int64(Offset.Z) * Offset.Z;
+			*OutNearestDistanceSq = FMath::Min(*OutNearestDistanceSq, DistanceSq);
+		}
+
+		const int32 RadiusXY = Observer->StreamingRadius.X + Margin;
+		const int32 RadiusZ = Observer->StreamingRadius.Y + Margin;
+		if (Offset.X * Offset.X + Offset.Y * Offset.Y <= RadiusXY * RadiusXY && FMath::Abs(Offset.Z) <= RadiusZ)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+FTS_ChunkSchedulerView UTS_ChunkManager::GetSchedulerView() const
+{
+	FTS_ChunkSchedulerView View;
+	View.CosHalfViewAngle = FMath::Cos(FMath::DegreesToRadians(FMath::Clamp(SchedulingViewAngle, 1.0f, 360.0f) * 0.5f));
+	View.ChunkRadius = ChunkSize * VoxelSize * 0.5f * UE_SQRT_3;
+
+	ForEachObserver([&View](const FTS_StreamingObserver& Observer, const AActor& Actor)
+	{
+		FTS_ChunkSchedulerObserver& SchedulerObserver = View.Observers.AddDefaulted_GetRef();
+		FRotator ViewRotation;
+		Actor.GetActorEyesViewPoint(SchedulerObserver.Location, ViewRotation);
+		SchedulerObserver.Forward = ViewRotation.Vector();
+		SchedulerObserver.PriorityWeight = Observer.PriorityWeight;
+	});
+
+	return View;
+}
+
+int32 UTS_ChunkManager::GetNumAsyncTasks() const
+{
+	// Retired tasks still occupy a worker until they notice they were cancelled
+	return NumGenerationTasks + NumMeshTasks + RetiredGenerationTasks.Num() + RetiredMeshTasks.Num();
+}
+
+int32 UTS_ChunkManager::GetMaxConcurrentAsyncTasks() const
+{
+	if (MaxConcurrentAsyncTasks > 0)
+	{
+		return MaxConcurrentAsyncTasks;
+	}
+	if (bWorkerPoolFailed && GThreadPool)
+	{
+		return FMath::Max(1, GThreadPool->GetNumThreads());
+	}
+	return WorkerPool.IsRunning() ? WorkerPool.GetNumThreads() 
+		: (WorkerThreadCount > 0 ? WorkerThreadCount : FTS_WorkerPool::GetDefaultNumThreads());
+}
+
+FQueuedThreadPool* UTS_ChunkManager::GetTaskThreadPool()
+{
+	if (bWorkerPoolFailed)
+	{
+		return GThreadPool;
+	}
+
+	if (!WorkerPool.IsRunning())
+	{
+		EThreadPriority Priority = TPri_BelowNormal;
+		switch (WorkerThreadPriority)
+		{
+			case ETS_WorkerThreadPriority::Normal: Priority = TPri_Normal; break;
+			case ETS_WorkerThreadPriority::Lowest: Priority = TPri_Lowest; break;
+			default: Priority = TPri_BelowNormal; break;
+		}
+
+		if (!WorkerPool.Start(WorkerThreadCount, Priority, static_cast<uint64>(WorkerAffinityMask)))
+		{
+			UE_LOG(LogTerraScape, Warning, TEXT("TerraScape: Running chunk tasks on the engine thread pool instead"));
+			bWorkerPoolFailed = true;
+			return GThreadPool;
+		}
+	}
+	return WorkerPool.GetPool();
+}
+
+void UTS_ChunkManager::GenerateChunkGrid(const FIntVector& CenterChunk, int32 GridSize)
+{
+	if (GridSize <= 0 || GridSize > 100)
+	{
+		UE_LOG(LogTerraScape, Warning, TEXT("Invalid grid size: %d (must be 1-100)"), GridSize);
+		return;
+	}
+
+	int32 ChunksGenerated = 0;
+	int32 TotalChunks = GridSize * GridSize;
+	
+	UE_LOG(LogTerraScape, Log, TEXT("Generating chunk grid: center=%s, size=%dx%d (%d chunks)"), 
+		*CenterChunk.ToString(), GridSize, GridSize, TotalChunks);
+
+	// Calculate half size for centering
+	int32 HalfSize = GridSize / 2;
+	int32 StartX = CenterChunk.X - HalfSize;
+	int32 StartY = CenterChunk.Y - HalfSize;
+
+	// Generate 2D grid for chunk streaming (Z=0 only for continuous terrain)
+	for (int32 X = 0; X < GridSize; X++)
+	{
+		for (int32 Y = 0; Y < GridSize; Y++)
+		{
+			FIntVector ChunkID(StartX + X, StartY + Y, 0); // Always Z=0 for continuous terrain
+			
+			// Only create if it doesn't already exist
+			if (!ChunkRecords.Contains(ChunkID))
+			{
+				CreateChunk(ChunkID);
+				ChunksGenerated++;
 			}
 		}
-		
-		MeshComp->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
 	}
+
+	UE_LOG(LogTerraScape, Log, TEXT("Generated %d new chunks in continuous 2D grid"), ChunksGenerated);
 }
 
-FTS_Voxel UTS_ChunkManager::GetVoxelAt(const FIntVector& ChunkID, int32 X, int32 Y, int32 Z) const
+void UTS_ChunkManager::ClearAllChunks()
+{
+	int32 ChunksToDelete = ChunkRecords.Num();
+	int32 QueuedChunks = GenerationScheduler.Num() + MeshScheduler.Num();
+	
+	UE_LOG(LogTerraScape, Log, TEXT("Clearing all %d chunks and %d queued chunks"), ChunksToDelete, QueuedChunks);
+
+	// Clear pending queues FIRST to prevent new chunks from being created
+	GenerationScheduler.Empty();
+	MeshScheduler.Empty();
+
+	// Streaming starts over from the nearest chunk next tick
+	StreamingUnloadList.Empty();
+	bStreamingUnloadListDirty = false;
+	PlayerObserver.bHasStreamingCenter = false;
+	for (FTS_StreamingObserver& Observer : StreamingObservers)
+	{
+		Observer.bHasStreamingCenter = false;
+	}
+
+	// Cancel every task, then wait for the ones already running; they stop at their next check,
+	// and nothing may still be using the world generator or material manager afterwards
+	for (FTS_ChunkRecord& Record : ChunkRecords)
+	{
+		CancelGenerationTask(Record);
+		CancelMeshTask(Record);
+	}
+
+	WaitForRetiredTasks(RetiredGenerationTasks);
+	WaitForRetiredTasks(RetiredMeshTasks);
+
+	// Finished meshes that were never uploaded
+	for (FTS_ChunkRecord& Record : ChunkRecords)
+	{
+		DiscardReadyMesh(Record);
+	}
+	UploadScheduler.Empty();
+
+	// Notices from the tasks dropped above
+	CompletionQueue->Empty();
+
+	// Get all chunk IDs before deleting (to avoid iterator issues)
+	TArray<FIntVector> ChunkIDs;
+	ChunkRecords.GetKeys(ChunkIDs);
+
+	// Delete each chunk
+	for (const FIntVector& ChunkID : ChunkIDs)
+	{
+		DeleteChunk(ChunkID);
+	}
+
+	UE_LOG(LogTerraScape, Log, TEXT("Cleared all chunks, queue, and async tasks"));
+}
+
+// Async Voxel Generation Task Implementation
+void FTS_AsyncVoxelGenerationTask::DoWork()
+{
+	FTS_WorkerPool::ApplyAffinityToCurrentThread(Context.AffinityMask);
+	GenerateChunkVoxels();
+	Context.Notify(ChunkID, ETS_ChunkTaskType::VoxelGeneration);
+}
+
+bool FTS_AsyncVoxelGenerationTask::LoadStoredVoxels()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FTS_AsyncVoxelGenerationTask::LoadStoredVoxels);
+
+	if (!RegionStore.IsValid() || !RegionStore->LoadChunk(ChunkID, VoxelStorage, bIsUniform, UniformMaterialID, &bLoadedUnsaved))
+	{
+		return false;
+	}
+
+	bLoadedFromRegion = true;
+	if (bIsUniform)
+	{
+		SolidVoxelCount = UniformMaterialID > 0 ? ChunkSize * ChunkSize * ChunkSize : 0;
+		return true;
+	}
+
+	// Mips aren't stored, they depend on the current LOD settings
+	SolidVoxelCount = VoxelStorage.CountSolidVoxels();
+	if (!Context.IsCancelled())
+	{
+		VoxelStorage.BuildMips(NumMipLevels, LODReduction == ETS_LODReduction::AnySolid);
+	}
+	return true;
+}
+
+void FTS_AsyncVoxelGenerationTask::GenerateChunkVoxels()
+{
+	SCOPE_CYCLE_COUNTER(STAT_TerraScape_Generation);
+	TRACE_CPUPROFILER_EVENT_SCOPE(FTS_AsyncVoxelGenerationTask::GenerateChunkVoxels);
+
+	// A saved chunk decompresses much faster than it generates, and carries the player's edits
+	if (LoadStoredVoxels())
+	{
+		return;
+	}
+
+	// Flat scratch array for the generator, packed into the paletted storage below
+	TArray<FTS_Voxel> Voxels;
+	if (bUseProceduralGeneration && WorldGenerator)
+	{
+		GenerateProceduralVoxels(Voxels);
+	}
+	else
+	{
+		if (bUseProceduralGeneration)
+		{
+			UE_LOG(LogTerraScape, Warning, TEXT("WorldGenerator is null, falling back to test voxels"));
+		}
+		GenerateTestVoxels(Voxels);
+	}
+
+	// Superseded while generating, the voxels may be incomplete
+	if (Context.IsCancelled())
+	{
+		return;
+	}
+
+	// The generator already classified the chunk from its bounds and heightmap
+	if (bIsUniform)
+	{
+		SolidVoxelCount = UniformMaterialID > 0 ? ChunkSize * ChunkSize * ChunkSize : 0;
+		return;
+	}
+
+	SolidVoxelCount = 0;
+	for (const FTS_Voxel& Voxel : Voxels)
+	{
+		if (Voxel.IsSolid())
+		{
+			SolidVoxelCount++;
+		}
+	}
+
+	VoxelStorage.SetFromVoxels(ChunkSize, Voxels);
+
+	// Catch uniform chunks the bounds test couldn't prove (e.g. caves that didn't reach this chunk)
+	if (VoxelStorage.IsUniform())
+	{
+		bIsUniform = true;
+		UniformMaterialID = VoxelStorage.GetPalette()[0];
+		VoxelStorage = FTS_ChunkVoxelStorage();
+		return;
+	}
+
+	// Downsampled levels for LOD meshing, built here so the game thread never pays for them
+	if (Context.IsCancelled())
+	{
+		return;
+	}
+	VoxelStorage.BuildMips(NumMipLevels, LODReduction == ETS_LODReduction::AnySolid);
+}
+
+void FTS_AsyncVoxelGenerationTask::GenerateProceduralVoxels(TArray<FTS_Voxel>& OutVoxels)
+{
+	// Chunk-level pass: heightmap and climate once per column, then the 3D fill
+	bIsUniform = WorldGenerator->GenerateChunkVoxelData(ChunkWorldPos, ChunkSize, VoxelSize, OutVoxels, UniformMaterialID, &Context.bCancelled);
+
+	UE_LOG(LogTerraScape, Verbose, TEXT("Generated procedural voxels for chunk %d,%d,%d"), ChunkID.X, ChunkID.Y, ChunkID.Z);
+}
+
+void FTS_AsyncVoxelGenerationTask::GenerateTestVoxels(TArray<FTS_Voxel>& OutVoxels)
+{
+	// Create simple test pattern for MVP - Minecraft-style terrain
+	const int32 TotalVoxels = ChunkSize * ChunkSize * ChunkSize;
+	OutVoxels.Reset(TotalVoxels);
+
+	for (int32 Z = 0; Z < ChunkSize; Z++)
+	{
+		for (int32 Y = 0; Y < ChunkSize; Y++)
+		{
+			for (int32 X = 0; X < ChunkSize; X++)
+			{
+				FTS_Voxel NewVoxel;
+				
+				// Calculate world position of this voxel
+				FVector WorldPos = FVector(
+					ChunkID.X * ChunkSize + X,
+					ChunkID.Y * ChunkSize + Y,
+					ChunkID.Z * ChunkSize + Z
+				) * VoxelSize;
+				
+				// Create continuous terrain - simple ground plane at Z=0 with some thickness
+				float GroundHeight = 0.0f; // Ground level
+				float TerrainThickness = 4.0f * VoxelSize; // 4 voxels thick (400 units)
+				
+				// Simple continuous terrain - if we're at or below ground level, make it solid
+				if (WorldPos.Z <= GroundHeight && WorldPos.Z > (GroundHeight - TerrainThickness))
+				{
+					NewVoxel.MaterialID = 1; // Solid (ground)
+				}
+				else
+				{
+					NewVoxel.MaterialID = 0; // Air (sky)
+				}
+
+				OutVoxels.Add(NewVoxel);
+			}
+		}
+	}
+}
+
+// Async Mesh Generation Task Implementation
+void FTS_AsyncMeshGenerationTask::DoWork()
+{
+	FTS_WorkerPool::ApplyAffinityToCurrentThread(Context.AffinityMask);
+	GenerateChunkMesh();
+	Context.Notify(ChunkID, ETS_ChunkTaskType::MeshGeneration);
+}
+
+void FTS_AsyncMeshGenerationTask::GenerateChunkMesh()
 {
-	if (!ChunkVoxelData.Contains(ChunkID))
+	SCOPE_CYCLE_COUNTER(STAT_TerraScape_Meshing);
+	TRACE_CPUPROFILER_EVENT_SCOPE(FTS_AsyncMeshGenerationTask::GenerateChunkMesh);
+
+	// Safety check: Ensure voxel data is valid
+	if (VoxelData->GetChunkSize() != ChunkSize)
+	{
+		UE_LOG(LogTerraScape, Error, TEXT("Voxel data size mismatch: expected %d, got %d"), 
+			ChunkSize * ChunkSize * ChunkSize, VoxelData->Num());
+		return;
+	}
+
+	// ChunkWorldPos is now passed to the async task
+	UE_LOG(LogTerraScape, VeryVerbose, TEXT("Async task chunk world position: %s (ChunkID=%s, ChunkSize=%d, VoxelSize=%.1f)"), 
+		*ChunkWorldPos.ToString(), *ChunkID.ToString(), ChunkSize, VoxelSize);
+
+	// Calculate LOD step size (skip voxels for lower detail)
+	int32 LODStep = 1;
+	switch (LODLevel)
+	{
+		case 0: LODStep = 1; break;  // Full detail
+		case 1: LODStep = 2; break;  // Half detail
+		case 2: LODStep = 4; break;  // Quarter detail
+		case 3: LODStep = 8; break;  // Eighth detail
+		default: LODStep = 1; break;
+	}
+
+	// Safety check: one 64-bit word holds a whole column plus its two apron voxels
+	GridStep = LODStep;
+	GridSize = FMath::Max(1, ChunkSize / LODStep);
+	if (GridSize > MaxGridSize)
+	{
+		UE_LOG(LogTerraScape, Error, TEXT("Invalid chunk size: %d (at most %d cells per axis can be meshed, got %d at LOD %d)"), 
+			ChunkSize, MaxGridSize, GridSize, LODLevel);
+		return;
+	}
+
+	// Coarse LODs mesh the matching mip level so every cell stands for its whole block of voxels
+	CellData = VoxelData->GetMip(LODLevel);
+	if (!CellData || CellData->GetChunkSize() != GridSize)
+	{
+		// Supported: chunks generated before LOD was enabled or NumLODMipLevels raised keep their old mips
+		UE_LOG(LogTerraScape, Verbose, TEXT("Chunk %s has no mip for LOD %d, point-sampling full-resolution voxels"), 
+			*ChunkID.ToString(), LODLevel);
+		CellData = nullptr;
+	}
+
+	UE_LOG(LogTerraScape, Verbose, TEXT("Generating mesh for chunk %s with LOD level %d (step size %d)"), 
+		*ChunkID.ToString(), LODLevel, LODStep);
+
+	// Vertex color doesn't change per face, look it up once per task
+	FColor VertexColor = FColor(0, 255, 0); // Default green
+	if (bCollisionOnly)
+	{
+		// No render attributes at all
+	}
+	else if (MaterialManager && MaterialManager->IsInitialized())
+	{
+		// Get color from material data (for now, use material ID 1 for grass)
+		VertexColor = MaterialManager->GetVertexColor(1);
+	}
+	else
+	{
+		UE_LOG(LogTerraScape, Verbose, TEXT("MaterialManager not initialized, using default green color"));
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Face detection on whole columns at once, only set bits are turned into quads
+	const int32 SolidCells = BuildSolidColumns();
+	if (Context.IsCancelled())
+	{
+		return;
+	}
+	BuildFaceColumns();
+
+	int32 VisibleFaces = 0;
+	for (int32 FaceIndex = 0; FaceIndex < 6; FaceIndex++)
+	{
+		for (uint64 Column : FaceColumns[FaceIndex])
+		{
+			VisibleFaces += FMath::CountBits(Column);
+		}
+	}
+
+	UE_LOG(LogTerraScape, VeryVerbose, TEXT("Async task for chunk %s: %d solid cells, %d visible faces out of %d cells (neighbour mask 0x%02x)"), 
+		*ChunkID.ToString(), SolidCells, VisibleFaces, GridSize * GridSize * GridSize, Apron.LoadedMask);
+
+	// Collision is always merged, it is what the physics scene pays for
+	if (MeshingMode == ETS_MeshingMode::Greedy || bCollisionOnly)
+	{
+		GenerateGreedyMesh(VertexColor);
+	}
+	else
+	{
+		GenerateNaiveMesh(VisibleFaces, VertexColor);
+	}
+
+	BuildTimeMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	// Set up material interface
+	if (bCollisionOnly)
 	{
-		return FTS_Voxel(); // Return air voxel
+		// Never rendered
 	}
-
-	if (X < 0 || X >= ChunkSize || Y < 0 || Y >= ChunkSize || Z < 0 || Z >= ChunkSize)
+	else if (MaterialManager && MaterialManager->IsInitialized())
 	{
-		return FTS_Voxel(); // Return air voxel for out of bounds
+		// Use material ID 1 (grass) for all chunks
+		MaterialInterface = MaterialManager->GetMaterialInterface(1);
+		UE_LOG(LogTerraScape, VeryVerbose, TEXT("Async task: Using material from data table"));
 	}
-
-	const TArray<FTS_Voxel>& VoxelData = ChunkVoxelData[ChunkID];
-	int32 Index = Z * ChunkSize * ChunkSize + Y * ChunkSize + X;
-	
-	if (Index >= 0 && Index < VoxelData.Num())
+	else
 	{
-		return VoxelData[Index];
+		UE_LOG(LogTerraScape, Verbose, TEXT("Async task: MaterialManager not initialized, no material will be set"));
 	}
-	
-	return FTS_Voxel(); // Return air voxel
-}
 
-bool UTS_ChunkManager::IsVoxelSolid(const FIntVector& ChunkID, int32 X, int32 Y, int32 Z) const
-{
-	FTS_Voxel Voxel = GetVoxelAt(ChunkID, X, Y, Z);
-	return Voxel.IsSolid();
+	// No need to offset vertices - the chunk world position is already offset
+
+	// Debug: Log mesh generation results
+	UE_LOG(LogTerraScape, Verbose, TEXT("Async mesh generation complete for chunk %s (%s): %d vertices, %d triangles in %.2f ms"), 
+		*ChunkID.ToString(), bCollisionOnly ? TEXT("collision") : MeshingMode == ETS_MeshingMode::Greedy ? TEXT("greedy") : TEXT("naive"),
+		Vertices.Num(), Triangles.Num() / 3, BuildTimeMs);
 }
 
-void UTS_ChunkManager::CheckAsyncMeshTasks()
+int32 FTS_AsyncMeshGenerationTask::BuildSolidColumns()
 {
-	// Check for completed async tasks
-	TArray<FIntVector> CompletedTasks;
-	
-	for (auto& TaskPair : AsyncMeshTasks)
+	const int32 PaddedSize = GridSize + 2;
+	SolidColumns.Init(0, PaddedSize * PaddedSize);
+
+	// Apron solidity next to a cell. The apron holds what the neighbour renders at its own LOD, so a
+	// coarse cell's face is only culled when the neighbour covers all of it; otherwise the face stays
+	// as a wall that closes the seam against a finer or coarser neighbour
+	auto GetApronBit = [this](int32 FaceIndex, int32 U, int32 V) -> uint64
 	{
-		FIntVector ChunkID = TaskPair.Key;
-		FAsyncTask<FTS_AsyncMeshGenerationTask>* Task = TaskPair.Value;
-		
-		if (Task && Task->IsDone())
+		for (int32 DV = 0; DV < GridStep; DV++)
 		{
-			// Task completed, apply the mesh
-			FTS_AsyncMeshGenerationTask& TaskResult = Task->GetTask();
-			
-			// Find the mesh component for this chunk
-			if (UProceduralMeshComponent* MeshComp = ChunkMeshes.FindRef(ChunkID))
+			for (int32 DU = 0; DU < GridStep; DU++)
 			{
-				// Apply the generated mesh data
-				if (TaskResult.Vertices.Num() > 0)
+				if (Apron.GetMaterial(FaceIndex, U * GridStep + DU, V * GridStep + DV, ChunkSize) <= 0)
 				{
-					MeshComp->CreateMeshSection(0, TaskResult.Vertices, TaskResult.Triangles, 
-						TaskResult.Normals, TaskResult.UVs, TaskResult.Colors, 
-						TArray<FProcMeshTangent>(), true);
-					
-					if (TaskResult.MaterialInterface)
-					{
-						MeshComp->SetMaterial(0, TaskResult.MaterialInterface);
-					}
-					
-					MeshComp->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-					
-					UE_LOG(LogTemp, Log, TEXT("Async mesh generation completed for chunk %s"), 
-						*ChunkID.ToString());
+					return 0;
 				}
 			}
-			
-			// Clean up the task
-			delete Task;
-			CompletedTasks.Add(ChunkID);
 		}
-	}
-	
-	// Remove completed tasks
-	for (const FIntVector& ChunkID : CompletedTasks)
+		return 1;
+	};
+
+	int32 SolidCells = 0;
+	for (int32 Y = 0; Y < GridSize; Y++)
 	{
-		AsyncMeshTasks.Remove(ChunkID);
-	}
-	
-	// Process pending mesh generation queue if we have available slots
-	while (PendingMeshGenerationQueue.Num() > 0 && AsyncMeshTasks.Num() < MaxConcurrentAsyncTasks)
-	{
-		FIntVector QueuedChunkID = PendingMeshGenerationQueue[0];
-		PendingMeshGenerationQueue.RemoveAt(0);
-		
-		UE_LOG(LogTemp, Log, TEXT("Processing queued chunk %s from pending queue"), *QueuedChunkID.ToString());
-		
-		// Start mesh generation for the queued chunk
-		if (LoadedChunks.Contains(QueuedChunkID) && ChunkVoxelData.Contains(QueuedChunkID))
+		for (int32 X = 0; X < GridSize; X++)
 		{
-			TArray<FTS_Voxel> VoxelData = ChunkVoxelData[QueuedChunkID];
-			
-			// Get LOD level for this chunk
-			int32 LODLevel = GetChunkLODLevel(QueuedChunkID);
-			
-			// Create async task for mesh generation
-			FAsyncTask<FTS_AsyncMeshGenerationTask>* AsyncTask = new FAsyncTask<FTS_AsyncMeshGenerationTask>(
-				QueuedChunkID, VoxelData, ChunkSize, VoxelSize, CalculateChunkWorldPosition(QueuedChunkID), MaterialManager, LODLevel);
-			
-			AsyncTask->StartBackgroundTask();
-			AsyncMeshTasks.Add(QueuedChunkID, AsyncTask);
-			
-			UE_LOG(LogTemp, Log, TEXT("Started queued async mesh generation for chunk %s (%d/%d tasks)"), 
-				*QueuedChunkID.ToString(), AsyncMeshTasks.Num(), MaxConcurrentAsyncTasks);
+			// Apron below and above, the cells in between
+			uint64 Column = GetApronBit(5, X, Y) | (GetApronBit(4, X, Y) << (GridSize + 1));
+			for (int32 Z = 0; Z < GridSize; Z++)
+			{
+				if (GetCellMaterial(X, Y, Z) > 0)
+				{
+					Column |= uint64(1) << (Z + 1);
+					SolidCells++;
+				}
+			}
+			SolidColumns[(X + 1) + (Y + 1) * PaddedSize] = Column;
 		}
 	}
-}
-
-void UTS_ChunkManager::GenerateChunkGrid(const FIntVector& CenterChunk, int32 GridSize)
-{
-	if (GridSize <= 0 || GridSize > 100)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("Invalid grid size: %d (must be 1-100)"), GridSize);
-		return;
-	}
 
-	int32 ChunksGenerated = 0;
-	int32 TotalChunks = GridSize * GridSize;
-	
-	UE_LOG(LogTemp, Log, TEXT("Generating chunk grid: center=%s, size=%dx%d (%d chunks)"), 
-		*CenterChunk.ToString(), GridSize, GridSize, TotalChunks);
-
-	// Calculate half size for centering
-	int32 HalfSize = GridSize / 2;
-	int32 StartX = CenterChunk.X - HalfSize;
-	int32 StartY = CenterChunk.Y - HalfSize;
-
-	// Generate 2D grid for chunk streaming (Z=0 only for continuous terrain)
-	for (int32 X = 0; X < GridSize; X++)
+	// Border columns come from the side aprons
+	for (int32 U = 0; U < GridSize; U++)
 	{
-		for (int32 Y = 0; Y < GridSize; Y++)
+		uint64 RightColumn = 0;
+		uint64 LeftColumn = 0;
+		uint64 ForwardColumn = 0;
+		uint64 BackColumn = 0;
+		for (int32 Z = 0; Z < GridSize; Z++)
 		{
-			FIntVector ChunkID(StartX + X, StartY + Y, 0); // Always Z=0 for continuous terrain
-			
-			// Only create if it doesn't already exist
-			if (!LoadedChunks.Contains(ChunkID))
-			{
-				CreateChunk(ChunkID);
-				ChunksGenerated++;
-			}
+			RightColumn |= GetApronBit(0, U, Z) << (Z + 1);
+			LeftColumn |= GetApronBit(1, U, Z) << (Z + 1);
+			ForwardColumn |= GetApronBit(2, U, Z) << (Z + 1);
+			BackColumn |= GetApronBit(3, U, Z) << (Z + 1);
 		}
+		SolidColumns[(GridSize + 1) + (U + 1) * PaddedSize] = RightColumn;
+		SolidColumns[(U + 1) * PaddedSize] = LeftColumn;
+		SolidColumns[(U + 1) + (GridSize + 1) * PaddedSize] = ForwardColumn;
+		SolidColumns[U + 1] = BackColumn;
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("Generated %d new chunks in continuous 2D grid"), ChunksGenerated);
+	return SolidCells;
 }
 
-void UTS_ChunkManager::ClearAllChunks()
+void FTS_AsyncMeshGenerationTask::BuildFaceColumns()
 {
-	int32 ChunksToDelete = LoadedChunks.Num();
-	int32 QueuedChunks = PendingMeshGenerationQueue.Num();
-	
-	UE_LOG(LogTemp, Log, TEXT("Clearing all %d chunks and %d queued chunks"), ChunksToDelete, QueuedChunks);
+	const int32 PaddedSize = GridSize + 2;
+	const uint64 InteriorMask = (uint64(1) << GridSize) - 1;
 
-	// Clear pending mesh generation queue FIRST to prevent new chunks from being created
-	PendingMeshGenerationQueue.Empty();
-	
-	// Cancel any running async tasks
-	for (auto& TaskPair : AsyncMeshTasks)
+	for (int32 FaceIndex = 0; FaceIndex < 6; FaceIndex++)
 	{
-		FAsyncTask<FTS_AsyncMeshGenerationTask>* Task = TaskPair.Value;
-		if (Task)
-		{
-			Task->Cancel();
-			delete Task;
-		}
+		FaceColumns[FaceIndex].SetNumUninitialized(GridSize * GridSize);
 	}
-	AsyncMeshTasks.Empty();
-
-	// Get all chunk IDs before deleting (to avoid iterator issues)
-	TArray<FIntVector> ChunkIDs;
-	LoadedChunks.GetKeys(ChunkIDs);
 
-	// Delete each chunk
-	for (const FIntVector& ChunkID : ChunkIDs)
+	for (int32 Y = 0; Y < GridSize; Y++)
 	{
-		DeleteChunk(ChunkID);
+		for (int32 X = 0; X < GridSize; X++)
+		{
+			const int32 ColumnIndex = X + Y * GridSize;
+			const int32 PaddedIndex = (X + 1) + (Y + 1) * PaddedSize;
+			const uint64 Column = SolidColumns[PaddedIndex];
+
+			// A face is visible where the cell is solid and its neighbour in that direction is not,
+			// the apron bits are then shifted out so bit Z is cell Z again
+			FaceColumns[0][ColumnIndex] = ((Column & ~SolidColumns[PaddedIndex + 1]) >> 1) & InteriorMask;          // Right
+			FaceColumns[1][ColumnIndex] = ((Column & ~SolidColumns[PaddedIndex - 1]) >> 1) & InteriorMask;          // Left
+			FaceColumns[2][ColumnIndex] = ((Column & ~SolidColumns[PaddedIndex + PaddedSize]) >> 1) & InteriorMask; // Forward
+			FaceColumns[3][ColumnIndex] = ((Column & ~SolidColumns[PaddedIndex - PaddedSize]) >> 1) & InteriorMask; // Back
+			FaceColumns[4][ColumnIndex] = ((Column & ~(Column >> 1)) >> 1) & InteriorMask;                          // Up
+			FaceColumns[5][ColumnIndex] = ((Column & ~(Column << 1)) >> 1) & InteriorMask;                          // Down
+		}
 	}
-
-	UE_LOG(LogTemp, Log, TEXT("Cleared all chunks, queue, and async tasks"));
-}
-
-// Async Mesh Generation Task Implementation
-void FTS_AsyncMeshGenerationTask::DoWork()
-{
-	GenerateChunkMesh();
 }
 
-void FTS_AsyncMeshGenerationTask::GenerateChunkMesh()
+void FTS_AsyncMeshGenerationTask::GenerateNaiveMesh(int32 VisibleFaces, const FColor& VertexColor)
 {
-	// Safety check: Ensure chunk size is reasonable
-	if (ChunkSize <= 0 || ChunkSize > 256)
-	{
-		UE_LOG(LogTemp, Error, TEXT("Invalid chunk size: %d"), ChunkSize);
-		return;
-	}
+	const float CellSize = VoxelSize * GridStep;
 
-	// Safety check: Ensure voxel data is valid
-	if (VoxelData.Num() != ChunkSize * ChunkSize * ChunkSize)
-	{
-		UE_LOG(LogTemp, Error, TEXT("Voxel data size mismatch: expected %d, got %d"), 
-			ChunkSize * ChunkSize * ChunkSize, VoxelData.Num());
-		return;
-	}
+	Vertices.Reserve(VisibleFaces * 4);
+	Triangles.Reserve(VisibleFaces * 6);
+	Normals.Reserve(VisibleFaces * 4);
+	UVs.Reserve(VisibleFaces * 4);
+	Colors.Reserve(VisibleFaces * 4);
 
-	// Debug: Count solid voxels in async task
-	int32 SolidVoxels = 0;
-	for (const FTS_Voxel& Voxel : VoxelData)
+	// One quad per set face bit
+	for (int32 FaceIndex = 0; FaceIndex < 6 && !Context.IsCancelled(); FaceIndex++)
 	{
-		if (Voxel.IsSolid())
+		for (int32 Y = 0; Y < GridSize; Y++)
 		{
-			SolidVoxels++;
+			for (int32 X = 0; X < GridSize; X++)
+			{
+				uint64 FaceBits = FaceColumns[FaceIndex][X + Y * GridSize];
+				while (FaceBits != 0)
+				{
+					const int32 Z = static_cast<int32>(FMath::CountTrailingZeros64(FaceBits));
+					FaceBits &= FaceBits - 1;
+
+					const FVector BasePos = ChunkWorldPos + FVector(X, Y, Z) * CellSize;
+					AddFaceQuad(FaceIndex, BasePos, BasePos + FVector(CellSize), VertexColor);
+				}
+			}
 		}
 	}
-	UE_LOG(LogTemp, Log, TEXT("Async task for chunk %s: %d solid voxels out of %d total, VoxelSize=%.1f"), 
-		*ChunkID.ToString(), SolidVoxels, VoxelData.Num(), VoxelSize);
-
-	// Face directions for culling (normalized directions, not scaled by VoxelSize)
-	const FVector FaceDirections[6] = {
-		FVector(1, 0, 0),   // Right
-		FVector(-1, 0, 0),  // Left
-		FVector(0, 1, 0),   // Forward
-		FVector(0, -1, 0),  // Back
-		FVector(0, 0, 1),   // Up
-		FVector(0, 0, -1)   // Down
-	};
+}
 
-	const FVector FaceNormals[6] = {
-		FVector(1, 0, 0),
-		FVector(-1, 0, 0),
-		FVector(0, 1, 0),
-		FVector(0, -1, 0),
-		FVector(0, 0, 1),
-		FVector(0, 0, -1)
-	};
+void FTS_AsyncMeshGenerationTask::GenerateGreedyMesh(const FColor& VertexColor)
+{
+	const float CellSize = VoxelSize * GridStep;
 
-	// ChunkWorldPos is now passed to the async task
-	UE_LOG(LogTemp, Log, TEXT("Async task chunk world position: %s (ChunkID=%s, ChunkSize=%d, VoxelSize=%.1f)"), 
-		*ChunkWorldPos.ToString(), *ChunkID.ToString(), ChunkSize, VoxelSize);
-	
-	// Debug: Log first voxel position to verify alignment
-	if (Vertices.Num() > 0)
-	{
-		UE_LOG(LogTemp, Log, TEXT("First vertex position: %s (should be at ChunkWorldPos: %s)"), 
-			*Vertices[0].ToString(), *ChunkWorldPos.ToString());
-	}
-	
-	// Debug: Log chunk bounds
-	FVector ChunkMin = ChunkWorldPos;
-	FVector ChunkMax = ChunkWorldPos + FVector(ChunkSize * VoxelSize, ChunkSize * VoxelSize, ChunkSize * VoxelSize);
-	UE_LOG(LogTemp, Log, TEXT("Chunk bounds: Min=%s, Max=%s, Size=%s"), 
-		*ChunkMin.ToString(), *ChunkMax.ToString(), *FVector(ChunkSize * VoxelSize, ChunkSize * VoxelSize, ChunkSize * VoxelSize).ToString());
-	
-	// Performance tracking
-	int32 TotalVoxelsProcessed = 0;
-	int32 MaxVoxelsPerFrame = ChunkSize * ChunkSize * ChunkSize; // Allow processing all voxels in chunk
+	// Material of the visible face at each cell of the current slice (0 = no face); collision treats
+	// every solid material as 1 so faces merge across material borders and skips the lookups
+	TArray<int32> FaceMask;
+	FaceMask.SetNumUninitialized(GridSize * GridSize);
 
-	// Calculate LOD step size (skip voxels for lower detail)
-	int32 LODStep = 1;
-	switch (LODLevel)
+	for (int32 FaceIndex = 0; FaceIndex < 6 && !Context.IsCancelled(); FaceIndex++)
 	{
-		case 0: LODStep = 1; break;  // Full detail
-		case 1: LODStep = 2; break;  // Half detail
-		case 2: LODStep = 4; break;  // Quarter detail
-		case 3: LODStep = 8; break;  // Eighth detail
-		default: LODStep = 1; break;
-	}
+		// Face axis and the two axes spanning the slice, in the order used by AddFaceQuad
+		const int32 Axis = FaceIndex / 2;
+		const int32 AxisU = (Axis == 0) ? 1 : 0;
+		const int32 AxisV = (Axis == 2) ? 1 : 2;
 
-	UE_LOG(LogTemp, Log, TEXT("Generating mesh for chunk %s with LOD level %d (step size %d)"), 
-		*ChunkID.ToString(), LODLevel, LODStep);
+		const TArray<uint64>& Faces = FaceColumns[FaceIndex];
 
-	// Generate mesh data with LOD
-	for (int32 X = 0; X < ChunkSize; X += LODStep)
-	{
-		for (int32 Y = 0; Y < ChunkSize; Y += LODStep)
+		// Z slices that have at least one visible face
+		uint64 ZSlicesWithFaces = 0;
+		for (uint64 Column : Faces)
+		{
+			ZSlicesWithFaces |= Column;
+		}
+
+		for (int32 Slice = 0; Slice < GridSize; Slice++)
 		{
-			for (int32 Z = 0; Z < ChunkSize; Z += LODStep)
+			bool bSliceHasFaces = false;
+			FMemory::Memzero(FaceMask.GetData(), FaceMask.Num() * sizeof(int32));
+
+			if (Axis == 2)
 			{
-				// Safety check: Prevent infinite loops
-				TotalVoxelsProcessed++;
-				if (TotalVoxelsProcessed > MaxVoxelsPerFrame)
+				// Up/Down: the slice is one bit of every column
+				if ((ZSlicesWithFaces >> Slice) & 1)
 				{
-					UE_LOG(LogTemp, Error, TEXT("Mesh generation exceeded safety limit (%d voxels), aborting"), MaxVoxelsPerFrame);
-					return;
+					bSliceHasFaces = true;
+					for (int32 ColumnIndex = 0; ColumnIndex < Faces.Num(); ColumnIndex++)
+					{
+						if ((Faces[ColumnIndex] >> Slice) & 1)
+						{
+							FaceMask[ColumnIndex] = bCollisionOnly ? 1 : GetCellMaterial(ColumnIndex % GridSize, ColumnIndex / GridSize, Slice);
+						}
+					}
 				}
-				
-				// Only generate faces for solid voxels
-				if (!IsVoxelSolid(X, Y, Z))
+			}
+			else
+			{
+				// Side faces: the slice is a row of columns, walk the set bits of each
+				for (int32 U = 0; U < GridSize; U++)
 				{
-					continue;
+					const int32 X = (Axis == 0) ? Slice : U;
+					const int32 Y = (Axis == 0) ? U : Slice;
+
+					uint64 FaceBits = Faces[X + Y * GridSize];
+					bSliceHasFaces |= FaceBits != 0;
+					while (FaceBits != 0)
+					{
+						const int32 Z = static_cast<int32>(FMath::CountTrailingZeros64(FaceBits));
+						FaceBits &= FaceBits - 1;
+						FaceMask[U + Z * GridSize] = bCollisionOnly ? 1 : GetCellMaterial(X, Y, Z);
+					}
 				}
+			}
+
+			if (!bSliceHasFaces)
+			{
+				continue;
+			}
 
-				// Check each face
-				for (int32 FaceIndex = 0; FaceIndex < 6; FaceIndex++)
+			// Merge the mask into maximal rectangles of the same material
+			for (int32 V = 0; V < GridSize; V++)
+			{
+				for (int32 U = 0; U < GridSize; )
 				{
-					FVector NeighborPos = FVector(X, Y, Z) + FaceDirections[FaceIndex];
-					bool bNeighborIsAir = true;
+					const int32 MaterialID = FaceMask[U + V * GridSize];
+					if (MaterialID == 0)
+					{
+						U++;
+						continue;
+					}
 
-					// Check if neighbor is air (face culling)
-					if (NeighborPos.X >= 0 && NeighborPos.X < ChunkSize &&
-						NeighborPos.Y >= 0 && NeighborPos.Y < ChunkSize &&
-						NeighborPos.Z >= 0 && NeighborPos.Z < ChunkSize)
+					// Grow along U
+					int32 Width = 1;
+					while (U + Width < GridSize && FaceMask[U + Width + V * GridSize] == MaterialID)
 					{
-						bNeighborIsAir = !IsVoxelSolid(NeighborPos.X, NeighborPos.Y, NeighborPos.Z);
+						Width++;
 					}
 
-					// Only generate face if neighbor is air (face culling)
-					if (bNeighborIsAir)
+					// Grow along V while the whole row matches
+					int32 Height = 1;
+					bool bRowMatches = true;
+					while (V + Height < GridSize && bRowMatches)
 					{
-					// Generate quad for this face (scale by LOD step)
-					FVector BasePos = ChunkWorldPos + FVector(X * VoxelSize, Y * VoxelSize, Z * VoxelSize);
-					FVector Normal = FaceNormals[FaceIndex];
-					float LODVoxelSize = VoxelSize * LODStep;
-						
-						// Define quad vertices based on face direction (consistent counter-clockwise order)
-						TArray<FVector> QuadVertices;
-						QuadVertices.SetNum(4);
-						
-						if (FaceIndex == 0) // Right
-						{
-							QuadVertices[0] = BasePos + FVector(VoxelSize, 0, 0);
-							QuadVertices[1] = BasePos + FVector(VoxelSize, 0, VoxelSize);
-							QuadVertices[2] = BasePos + FVector(VoxelSize, VoxelSize, VoxelSize);
-							QuadVertices[3] = BasePos + FVector(VoxelSize, VoxelSize, 0);
-						}
-						else if (FaceIndex == 1) // Left
-						{
-							QuadVertices[0] = BasePos + FVector(0, VoxelSize, 0);
-							QuadVertices[1] = BasePos + FVector(0, VoxelSize, VoxelSize);
-							QuadVertices[2] = BasePos + FVector(0, 0, VoxelSize);
-							QuadVertices[3] = BasePos + FVector(0, 0, 0);
-						}
-						else if (FaceIndex == 2) // Forward
+						for (int32 RowU = U; RowU < U + Width; RowU++)
 						{
-							QuadVertices[0] = BasePos + FVector(0, VoxelSize, 0);
-							QuadVertices[1] = BasePos + FVector(VoxelSize, VoxelSize, 0);
-							QuadVertices[2] = BasePos + FVector(VoxelSize, VoxelSize, VoxelSize);
-							QuadVertices[3] = BasePos + FVector(0, VoxelSize, VoxelSize);
+							if (FaceMask[RowU + (V + Height) * GridSize] != MaterialID)
+							{
+								bRowMatches = false;
+								break;
+							}
 						}
-						else if (FaceIndex == 3) // Back
+						if (bRowMatches)
 						{
-							QuadVertices[0] = BasePos + FVector(VoxelSize, 0, 0);
-							QuadVertices[1] = BasePos + FVector(0, 0, 0);
-							QuadVertices[2] = BasePos + FVector(0, 0, VoxelSize);
-							QuadVertices[3] = BasePos + FVector(VoxelSize, 0, VoxelSize);
-						}
-						else if (FaceIndex == 4) // Up
-						{
-							QuadVertices[0] = BasePos + FVector(0, 0, VoxelSize);
-							QuadVertices[1] = BasePos + FVector(0, VoxelSize, VoxelSize);
-							QuadVertices[2] = BasePos + FVector(VoxelSize, VoxelSize, VoxelSize);
-							QuadVertices[3] = BasePos + FVector(VoxelSize, 0, VoxelSize);
-						}
-						else if (FaceIndex == 5) // Down
-						{
-							QuadVertices[0] = BasePos + FVector(0, 0, 0);
-							QuadVertices[1] = BasePos + FVector(VoxelSize, 0, 0);
-							QuadVertices[2] = BasePos + FVector(VoxelSize, VoxelSize, 0);
-							QuadVertices[3] = BasePos + FVector(0, VoxelSize, 0);
+							Height++;
 						}
+					}
 
-						// Add vertices
-						int32 StartIndex = Vertices.Num();
-						Vertices.Append(QuadVertices);
-						
-						// Add triangles (two triangles per quad) - counter-clockwise winding for outward normals
-						Triangles.Add(StartIndex);
-						Triangles.Add(StartIndex + 1);
-						Triangles.Add(StartIndex + 2);
-						
-						Triangles.Add(StartIndex);
-						Triangles.Add(StartIndex + 2);
-						Triangles.Add(StartIndex + 3);
-
-						// Add normals
-						for (int32 i = 0; i < 4; i++)
-						{
-							Normals.Add(Normal);
-						}
+					// Emit the rectangle as one quad
+					FIntVector MinCell;
+					MinCell[Axis] = Slice;
+					MinCell[AxisU] = U;
+					MinCell[AxisV] = V;
 
-						// Add UVs (simple mapping)
-						UVs.Add(FVector2D(0, 0));
-						UVs.Add(FVector2D(1, 0));
-						UVs.Add(FVector2D(1, 1));
-						UVs.Add(FVector2D(0, 1));
+					FIntVector MaxCell;
+					MaxCell[Axis] = Slice + 1;
+					MaxCell[AxisU] = U + Width;
+					MaxCell[AxisV] = V + Height;
 
-						// Add vertex colors from material system
-						FColor VertexColor = FColor(0, 255, 0); // Default green
-						if (MaterialManager && MaterialManager->IsInitialized())
-						{
-							// Get color from material data (for now, use material ID 1 for grass)
-							VertexColor = MaterialManager->GetVertexColor(1);
-						}
-						else
-						{
-							UE_LOG(LogTemp, Warning, TEXT("MaterialManager not initialized, using default green color"));
-						}
-						for (int32 i = 0; i < 4; i++)
+					AddFaceQuad(FaceIndex,
+						ChunkWorldPos + FVector(MinCell) * CellSize,
+						ChunkWorldPos + FVector(MaxCell) * CellSize,
+						VertexColor);
+
+					// Clear the merged cells
+					for (int32 ClearV = V; ClearV < V + Height; ClearV++)
+					{
+						for (int32 ClearU = U; ClearU < U + Width; ClearU++)
 						{
-							Colors.Add(VertexColor);
+							FaceMask[ClearU + ClearV * GridSize] = 0;
 						}
 					}
+
+					U += Width;
 				}
 			}
 		}
 	}
+}
 
-	// Set up material interface
-	if (MaterialManager && MaterialManager->IsInitialized())
+void FTS_AsyncMeshGenerationTask::AddFaceQuad(int32 FaceIndex, const FVector& BoxMin, const FVector& BoxMax, const FColor& VertexColor)
+{
+	const FVector FaceNormals[6] = {
+		FVector(1, 0, 0),
+		FVector(-1, 0, 0),
+		FVector(0, 1, 0),
+		FVector(0, -1, 0),
+		FVector(0, 0, 1),
+		FVector(0, 0, -1)
+	};
+
+	// Define quad vertices based on face direction (consistent counter-clockwise order)
+	FVector QuadVertices[4];
+	if (FaceIndex == 0) // Right
 	{
-		// Use material ID 1 (grass) for all chunks
-		MaterialInterface = MaterialManager->GetMaterialInterface(1);
-		UE_LOG(LogTemp, Log, TEXT("Async task: Using material from data table"));
+		QuadVertices[0] = FVector(BoxMax.X, BoxMin.Y, BoxMin.Z);
+		QuadVertices[1] = FVector(BoxMax.X, BoxMin.Y, BoxMax.Z);
+		QuadVertices[2] = FVector(BoxMax.X, BoxMax.Y, BoxMax.Z);
+		QuadVertices[3] = FVector(BoxMax.X, BoxMax.Y, BoxMin.Z);
 	}
-	else
+	else if (FaceIndex == 1) // Left
+	{
+		QuadVertices[0] = FVector(BoxMin.X, BoxMax.Y, BoxMin.Z);
+		QuadVertices[1] = FVector(BoxMin.X, BoxMax.Y, BoxMax.Z);
+		QuadVertices[2] = FVector(BoxMin.X, BoxMin.Y, BoxMax.Z);
+		QuadVertices[3] = FVector(BoxMin.X, BoxMin.Y, BoxMin.Z);
+	}
+	else if (FaceIndex == 2) // Forward
+	{
+		QuadVertices[0] = FVector(BoxMin.X, BoxMax.Y, BoxMin.Z);
+		QuadVertices[1] = FVector(BoxMax.X, BoxMax.Y, BoxMin.Z);
+		QuadVertices[2] = FVector(BoxMax.X, BoxMax.Y, BoxMax.Z);
+		QuadVertices[3] = FVector(BoxMin.X, BoxMax.Y, BoxMax.Z);
+	}
+	else if (FaceIndex == 3) // Back
+	{
+		QuadVertices[0] = FVector(BoxMax.X, BoxMin.Y, BoxMin.Z);
+		QuadVertices[1] = FVector(BoxMin.X, BoxMin.Y, BoxMin.Z);
+		QuadVertices[2] = FVector(BoxMin.X, BoxMin.Y, BoxMax.Z);
+		QuadVertices[3] = FVector(BoxMax.X, BoxMin.Y, BoxMax.Z);
+	}
+	else if (FaceIndex == 4) // Up
+	{
+		QuadVertices[0] = FVector(BoxMin.X, BoxMin.Y, BoxMax.Z);
+		QuadVertices[1] = FVector(BoxMin.X, BoxMax.Y, BoxMax.Z);
+		QuadVertices[2] = FVector(BoxMax.X, BoxMax.Y, BoxMax.Z);
+		QuadVertices[3] = FVector(BoxMax.X, BoxMin.Y, BoxMax.Z);
+	}
+	else // Down
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Async task: MaterialManager not initialized, no material will be set"));
+		QuadVertices[0] = FVector(BoxMin.X, BoxMin.Y, BoxMin.Z);
+		QuadVertices[1] = FVector(BoxMax.X, BoxMin.Y, BoxMin.Z);
+		QuadVertices[2] = FVector(BoxMax.X, BoxMax.Y, BoxMin.Z);
+		QuadVertices[3] = FVector(BoxMin.X, BoxMax.Y, BoxMin.Z);
 	}
 
-	// No need to offset vertices - the chunk world position is already offset
+	// Add vertices
+	const int32 StartIndex = Vertices.Num();
+	Vertices.Append(QuadVertices, 4);
 
-	// Debug: Log mesh generation results
-	UE_LOG(LogTemp, Log, TEXT("Async mesh generation complete for chunk %s: %d vertices, %d triangles"), 
-		*ChunkID.ToString(), Vertices.Num(), Triangles.Num());
-}
+	// Add triangles (two triangles per quad) - counter-clockwise winding for outward normals
+	Triangles.Add(StartIndex);
+	Triangles.Add(StartIndex + 1);
+	Triangles.Add(StartIndex + 2);
 
-FTS_Voxel FTS_AsyncMeshGenerationTask::GetVoxelAt(int32 X, int32 Y, int32 Z) const
-{
-	int32 Index = Z * ChunkSize * ChunkSize + Y * ChunkSize + X;
-	
-	if (Index >= 0 && Index < VoxelData.Num())
+	Triangles.Add(StartIndex);
+	Triangles.Add(StartIndex + 2);
+	Triangles.Add(StartIndex + 3);
+
+	if (bCollisionOnly)
+	{
+		return;
+	}
+
+	// Add normals
+	for (int32 i = 0; i < 4; i++)
 	{
-		return VoxelData[Index];
+		Normals.Add(FaceNormals[FaceIndex]);
+	}
+
+	// UVs tile once per voxel so merged quads keep the same texel density
+	const float SizeU = FVector::Dist(QuadVertices[0], QuadVertices[1]) / VoxelSize;
+	const float SizeV = FVector::Dist(QuadVertices[1], QuadVertices[2]) / VoxelSize;
+	UVs.Add(FVector2D(0, 0));
+	UVs.Add(FVector2D(SizeU, 0));
+	UVs.Add(FVector2D(SizeU, SizeV));
+	UVs.Add(FVector2D(0, SizeV));
+
+	for (int32 i = 0; i < 4; i++)
+	{
+		Colors.Add(VertexColor);
 	}
-	
-	return FTS_Voxel(); // Return air voxel
 }
 
-bool FTS_AsyncMeshGenerationTask::IsVoxelSolid(int32 X, int32 Y, int32 Z) const
+int32 FTS_AsyncMeshGenerationTask::GetCellMaterial(int32 X, int32 Y, int32 Z) const
 {
-	FTS_Voxel Voxel = GetVoxelAt(X, Y, Z);
-	return Voxel.IsSolid();
+	if (CellData)
+	{
+		return CellData->Get(X, Y, Z);
+	}
+
+	// No mips: each LOD cell takes the material of its first voxel
+	return VoxelData->Get(X * GridStep, Y * GridStep, Z * GridStep);
 }
 
 // LOD Implementation
 void UTS_ChunkManager::UpdateChunkLOD()
 {
-	if (!bEnableLOD || !PlayerReference)
+	TRACE_CPUPROFILER_EVENT_SCOPE(UTS_ChunkManager::UpdateChunkLOD);
+
+	if (!bEnableLOD || (!PlayerReference && StreamingObservers.Num() == 0))
 	{
 		return;
 	}
 
-	FVector PlayerLocation = PlayerReference->GetActorLocation();
 	int32 ChunksUpdated = 0;
 
 	// Check all loaded chunks for LOD updates
-	for (auto& ChunkPair : LoadedChunks)
+	for (FTS_ChunkRecord& Record : ChunkRecords)
 	{
-		FIntVector ChunkID = ChunkPair.Key;
-		int32 CurrentLOD = ChunkLODLevels.FindRef(ChunkID);
+		const FIntVector ChunkID = Record.ChunkID;
+
+		// Chunks still generating or waiting for their first mesh pick up their LOD when it starts
+		if (!Record.VoxelData.IsValid() || Record.LODLevel == INDEX_NONE)
+		{
+			continue;
+		}
+
+		int32 CurrentLOD = Record.LODLevel;
 		int32 NewLOD = GetChunkLODLevel(ChunkID);
 
 		// If LOD level changed, regenerate the chunk
 		if (CurrentLOD != NewLOD)
 		{
-			ChunkLODLevels.Add(ChunkID, NewLOD);
+			Record.LODLevel = NewLOD;
 			
-			// Cancel existing async task if any
-			if (FAsyncTask<FTS_AsyncMeshGenerationTask>** ExistingTask = AsyncMeshTasks.Find(ChunkID))
-			{
-				if (*ExistingTask)
-				{
-					(*ExistingTask)->Cancel();
-					delete *ExistingTask;
-				}
-				AsyncMeshTasks.Remove(ChunkID);
-			}
+			// The mesh being built (or waiting for upload) is for the old LOD, stop it without waiting
+			CancelMeshTask(Record);
+			DiscardReadyMesh(Record);
 
 			// Regenerate chunk with new LOD
-			if (ChunkVoxelData.Contains(ChunkID))
+			// Check if we can start a new async task
+			if (GetNumAsyncTasks() < GetMaxConcurrentAsyncTasks())
 			{
-				TArray<FTS_Voxel> VoxelData = ChunkVoxelData[ChunkID];
-				
-				// Check if we can start a new async task
-				if (AsyncMeshTasks.Num() < MaxConcurrentAsyncTasks)
-				{
-					FAsyncTask<FTS_AsyncMeshGenerationTask>* AsyncTask = new FAsyncTask<FTS_AsyncMeshGenerationTask>(
-						ChunkID, VoxelData, ChunkSize, VoxelSize, CalculateChunkWorldPosition(ChunkID), MaterialManager, NewLOD);
-					
-					AsyncTask->StartBackgroundTask();
-					AsyncMeshTasks.Add(ChunkID, AsyncTask);
-					
-					UE_LOG(LogTemp, Log, TEXT("Updated chunk %s to LOD level %d"), *ChunkID.ToString(), NewLOD);
-					ChunksUpdated++;
-				}
-				else
-				{
-					// Add to queue for later processing
-					PendingMeshGenerationQueue.Add(ChunkID);
-					UE_LOG(LogTemp, Warning, TEXT("Queued chunk %s for LOD update to level %d"), *ChunkID.ToString(), NewLOD);
-				}
+				StartMeshGeneration(ChunkID);
+				UE_LOG(LogTerraScape, Verbose, TEXT("Updated chunk %s to LOD level %d"), *ChunkID.ToString(), NewLOD);
+				ChunksUpdated++;
+			}
+			else
+			{
+				// Add to queue for later processing
+				MeshScheduler.Enqueue(ChunkID);
+				UE_LOG(LogTerraScape, Verbose, TEXT("Queued chunk %s for LOD update to level %d"), *ChunkID.ToString(), NewLOD);
 			}
 		}
 	}
 
 	if (ChunksUpdated > 0)
 	{
-		UE_LOG(LogTemp, Log, TEXT("Updated LOD for %d chunks"), ChunksUpdated);
+		UE_LOG(LogTerraScape, Log, TEXT("Updated LOD for %d chunks"), ChunksUpdated);
 	}
 }
 
 int32 UTS_ChunkManager::GetChunkLODLevel(const FIntVector& ChunkID) const
 {
-	if (!bEnableLOD || !PlayerReference)
+	if (!bEnableLOD)
 	{
 		return 0; // Full detail if LOD disabled
 	}
@@ -1009,9 +2334,16 @@ int32 UTS_ChunkManager::GetChunkLODLevel(const FIntVector& ChunkID) const
 	// Calculate chunk center position using single source of truth
 	FVector ChunkCenter = CalculateChunkWorldPosition(ChunkID) + FVector(ChunkSize * VoxelSize * 0.5f);
 
-	// Calculate distance to player
-	FVector PlayerLocation = PlayerReference->GetActorLocation();
-	float Distance = FVector::Dist(PlayerLocation, ChunkCenter);
+	// Detail follows the nearest observer
+	float Distance = MAX_flt;
+	ForEachObserver([&Distance, &ChunkCenter](const FTS_StreamingObserver& Observer, const AActor& Actor)
+	{
+		Distance = FMath::Min(Distance, FVector::Dist(Actor.GetActorLocation(), ChunkCenter));
+	});
+	if (Distance == MAX_flt)
+	{
+		return 0; // No observer: full detail
+	}
 
 	// Determine LOD level based on distance
 	if (Distance <= LOD0Distance)
@@ -1035,7 +2367,7 @@ int32 UTS_ChunkManager::GetChunkLODLevel(const FIntVector& ChunkID) const
 void UTS_ChunkManager::SetPlayerReference(AActor* Player)
 {
 	PlayerReference = Player;
-	UE_LOG(LogTemp, Log, TEXT("Set player reference for LOD calculations: %s"), 
+	UE_LOG(LogTerraScape, Log, TEXT("Set player reference for LOD calculations: %s"), 
 		Player ? *Player->GetName() : TEXT("None"));
 }
 
@@ -1050,54 +2382,10 @@ FVector UTS_ChunkManager::CalculateChunkWorldPosition(const FIntVector& ChunkID)
 	);
 }
 
-TArray<FTS_Voxel> UTS_ChunkManager::GenerateProceduralVoxels(const FIntVector& ChunkID)
-{
-	TArray<FTS_Voxel> VoxelData;
-	VoxelData.SetNum(ChunkSize * ChunkSize * ChunkSize);
-
-	if (!WorldGenerator)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("WorldGenerator is null, falling back to test voxels"));
-		return GenerateTestVoxels(ChunkID);
-	}
-
-	// Calculate chunk world position
-	FVector ChunkWorldPos = CalculateChunkWorldPosition(ChunkID);
-
-	// Generate voxels using world generator
-	for (int32 X = 0; X < ChunkSize; X++)
-	{
-		for (int32 Y = 0; Y < ChunkSize; Y++)
-		{
-			for (int32 Z = 0; Z < ChunkSize; Z++)
-			{
-				// Calculate world coordinates for this voxel
-				float WorldX = ChunkWorldPos.X + (X * VoxelSize);
-				float WorldY = ChunkWorldPos.Y + (Y * VoxelSize);
-				float WorldZ = ChunkWorldPos.Z + (Z * VoxelSize);
-
-				// Generate voxel using world generator
-				FTS_VoxelGenResult Result = WorldGenerator->GenerateVoxelAtLocation(WorldX, WorldY, WorldZ);
-
-				// Calculate array index
-				int32 Index = X + (Y * ChunkSize) + (Z * ChunkSize * ChunkSize);
-
-				// Create voxel
-				FTS_Voxel Voxel;
-				Voxel.MaterialID = Result.bIsSolid ? Result.MaterialID : 0;
-				VoxelData[Index] = Voxel;
-			}
-		}
-	}
-
-	UE_LOG(LogTemp, Log, TEXT("Generated procedural voxels for chunk %d,%d,%d"), ChunkID.X, ChunkID.Y, ChunkID.Z);
-	return VoxelData;
-}
-
 void UTS_ChunkManager::SetProceduralGenerationEnabled(bool bEnabled)
 {
 	bUseProceduralGeneration = bEnabled;
-	UE_LOG(LogTemp, Log, TEXT("Procedural generation %s"), bEnabled ? TEXT("enabled") : TEXT("disabled"));
+	UE_LOG(LogTerraScape, Log, TEXT("Procedural generation %s"), bEnabled ? TEXT("enabled") : TEXT("disabled"));
 }
 
 UTS_WorldGenerator* UTS_ChunkManager::GetWorldGenerator() const
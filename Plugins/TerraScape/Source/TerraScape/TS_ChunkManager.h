@@ -11,11 +11,243 @@
 #include "Components/ActorComponent.h"
 #include "ProceduralMeshComponent.h"
 #include "Async/AsyncWork.h"
+#include "Containers/Queue.h"
+#include <atomic>
 #include "TS_VoxelTypes.h"
+#include "TS_ChunkStorage.h"
+#include "TS_ChunkTable.h"
+#include "TS_RegionFile.h"
+#include "TS_ChunkScheduler.h"
+#include "TS_WorkerPool.h"
 #include "TS_MaterialData.h"
 #include "TS_WorldGenerator.h"
+#include "TS_Stats.h"
 #include "TS_ChunkManager.generated.h"
 
+/**
+ * @brief How chunk meshes are built from voxel data
+ */
+UENUM(BlueprintType)
+enum class ETS_MeshingMode : uint8
+{
+	/** One quad per exposed voxel face */
+	Naive UMETA(DisplayName = "Naive"),
+
+	/** Coplanar faces of the same material merged into maximal rectangles */
+	Greedy UMETA(DisplayName = "Greedy")
+};
+
+/**
+ * @brief How 2x2x2 voxel blocks are reduced when building the LOD mip pyramid
+ */
+UENUM(BlueprintType)
+enum class ETS_LODReduction : uint8
+{
+	/** Solid when at least half the block is solid; keeps the silhouette closest to full detail */
+	Majority UMETA(DisplayName = "Majority"),
+
+	/** Solid when any voxel of the block is solid; never opens holes, but thickens thin features */
+	AnySolid UMETA(DisplayName = "Any Solid")
+};
+
+/**
+ * @brief Scheduling priority of the TerraScape worker threads
+ */
+UENUM(BlueprintType)
+enum class ETS_WorkerThreadPriority : uint8
+{
+	/** Same as the game thread; for servers where terrain throughput matters most */
+	Normal UMETA(DisplayName = "Normal"),
+
+	/** Yields to the game and render threads when cores are scarce */
+	BelowNormal UMETA(DisplayName = "Below Normal"),
+
+	/** Only runs on otherwise idle cores */
+	Lowest UMETA(DisplayName = "Lowest")
+};
+
+/**
+ * @brief What chunk meshes are built for
+ */
+UENUM(BlueprintType)
+enum class ETS_ChunkMeshContent : uint8
+{
+	/** Collision only on dedicated servers, render meshes with collision everywhere else */
+	Auto UMETA(DisplayName = "Auto"),
+
+	/** Normals, UVs, vertex colours and materials plus collision */
+	RenderAndCollision UMETA(DisplayName = "Render And Collision"),
+
+	/** Positions and triangles only, merged across materials and never rendered */
+	CollisionOnly UMETA(DisplayName = "Collision Only")
+};
+
+/**
+ * @brief One-voxel border around a chunk, copied from its six face neighbours for seam-aware culling
+ * Faces are ordered like mesh faces (+X, -X, +Y, -Y, +Z, -Z). Each face holds ChunkSize * ChunkSize
+ * materials indexed U + V * ChunkSize, where (U, V) is (Y, Z) for X faces, (X, Z) for Y faces and
+ * (X, Y) for Z faces.
+ * Materials are taken at the LOD the neighbour renders at, so a face is only culled where the
+ * neighbour's actual geometry covers it and seams between different LODs stay closed.
+ */
+struct TERRA_SCAPE_API FTS_ChunkApron
+{
+	/** Material of the voxel just outside each face (empty when that neighbour isn't loaded) */
+	TArray<int32> Faces[6];
+
+	/** Bit per face, set when that neighbour's voxel data was available */
+	uint8 LoadedMask = 0;
+
+	/** LOD each neighbour was sampled at (0 when not loaded or uniform) */
+	uint8 FaceLODs[6] = { 0, 0, 0, 0, 0, 0 };
+
+	/** Loaded bits and 2-bit LOD per face packed together, to detect when a neighbour changed */
+	uint32 GetSignature() const
+	{
+		uint32 Signature = LoadedMask;
+		for (int32 FaceIndex = 0; FaceIndex < 6; FaceIndex++)
+		{
+			Signature |= uint32(FaceLODs[FaceIndex] & 3) << (8 + FaceIndex * 2);
+		}
+		return Signature;
+	}
+
+	/** Material just outside a face, air when the neighbour isn't loaded */
+	FORCEINLINE int32 GetMaterial(int32 FaceIndex, int32 U, int32 V, int32 ChunkSize) const
+	{
+		return Faces[FaceIndex].Num() > 0 ? Faces[FaceIndex][U + V * ChunkSize] : 0;
+	}
+};
+
+/** Kind of worker task that finished */
+enum class ETS_ChunkTaskType : uint8
+{
+	VoxelGeneration,
+	MeshGeneration
+};
+
+/**
+ * @brief Notice from a worker that its task is done
+ * TaskSerial identifies the task, so a notice from a task that was replaced or dropped since is ignored.
+ */
+struct FTS_ChunkTaskCompletion
+{
+	FIntVector ChunkID;
+	uint32 TaskSerial;
+	ETS_ChunkTaskType TaskType;
+};
+
+/** Lock-free queue workers push completion notices into and the game thread drains */
+using FTS_ChunkTaskCompletionQueue = TQueue<FTS_ChunkTaskCompletion, EQueueMode::Mpsc>;
+
+/**
+ * @brief A task's link to the chunk manager: its completion notice and cancellation flag
+ * Set up by the chunk manager before the task is started. A cancelled task stops at its next
+ * check and still posts its notice, so the manager knows when it can be deleted.
+ */
+struct FTS_ChunkTaskContext
+{
+	TSharedPtr<FTS_ChunkTaskCompletionQueue, ESPMode::ThreadSafe> Queue;
+	uint32 TaskSerial = 0;
+
+	/** Cores the worker running the task is pinned to, 0 for any */
+	uint64 AffinityMask = 0;
+
+	/** Set by the game thread when the result is no longer wanted */
+	std::atomic<bool> bCancelled{ false };
+
+	FORCEINLINE void Cancel() { bCancelled.store(true, std::memory_order_relaxed); }
+	FORCEINLINE bool IsCancelled() const { return bCancelled.load(std::memory_order_relaxed); }
+
+	FORCEINLINE void Notify(const FIntVector& ChunkID, ETS_ChunkTaskType TaskType) const
+	{
+		if (Queue.IsValid())
+		{
+			Queue->Enqueue(FTS_ChunkTaskCompletion{ ChunkID, TaskSerial, TaskType });
+		}
+	}
+};
+
+/**
+ * @brief Async task for generating chunk voxel data
+ * Runs the world generator off the game thread; the result is handed to the mesh task
+ */
+class TERRA_SCAPE_API FTS_AsyncVoxelGenerationTask : public FNonAbandonableTask
+{
+public:
+	FTS_AsyncVoxelGenerationTask(
+		const FIntVector& InChunkID,
+		int32 InChunkSize,
+		float InVoxelSize,
+		const FVector& InChunkWorldPos,
+		UTS_WorldGenerator* InWorldGenerator,
+		bool bInUseProceduralGeneration,
+		int32 InNumMipLevels = 0,
+		ETS_LODReduction InLODReduction = ETS_LODReduction::Majority,
+		TSharedPtr<FTS_RegionStore, ESPMode::ThreadSafe> InRegionStore = nullptr
+	)
+		: ChunkID(InChunkID)
+		, ChunkSize(InChunkSize)
+		, VoxelSize(InVoxelSize)
+		, ChunkWorldPos(InChunkWorldPos)
+		, WorldGenerator(InWorldGenerator)
+		, bUseProceduralGeneration(bInUseProceduralGeneration)
+		, NumMipLevels(InNumMipLevels)
+		, LODReduction(InLODReduction)
+		, RegionStore(MoveTemp(InRegionStore))
+	{
+	}
+
+	// FNonAbandonableTask interface
+	void DoWork();
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FTS_AsyncVoxelGenerationTask, STATGROUP_TerraScape);
+	}
+
+	/** Reports the finished task to the chunk manager */
+	FTS_ChunkTaskContext Context;
+
+	// Results
+	FTS_ChunkVoxelStorage VoxelStorage;
+	int32 SolidVoxelCount = 0;
+
+	/** Set when every voxel has the same material; VoxelStorage is left empty in that case */
+	bool bIsUniform = false;
+	int32 UniformMaterialID = 0;
+
+	/** Set when the voxels came from a region file instead of the generator */
+	bool bLoadedFromRegion = false;
+
+	/** Set when the loaded voxels are a save that hasn't reached its region file yet */
+	bool bLoadedUnsaved = false;
+
+private:
+	FIntVector ChunkID;
+	int32 ChunkSize;
+	float VoxelSize;
+	FVector ChunkWorldPos;
+	UTS_WorldGenerator* WorldGenerator;
+	bool bUseProceduralGeneration;
+	int32 NumMipLevels;
+	ETS_LODReduction LODReduction;
+
+	/** Saved chunks are loaded from here instead of generated, null when persistence is off */
+	TSharedPtr<FTS_RegionStore, ESPMode::ThreadSafe> RegionStore;
+
+	/** Load the chunk from the region store, false if it was never saved */
+	bool LoadStoredVoxels();
+
+	/** Generate the voxels and pack them into VoxelStorage */
+	void GenerateChunkVoxels();
+
+	/** Generate procedural voxel data using the world generator */
+	void GenerateProceduralVoxels(TArray<FTS_Voxel>& OutVoxels);
+
+	/** Generate simple test voxels (flat ground plane) */
+	void GenerateTestVoxels(TArray<FTS_Voxel>& OutVoxels);
+};
+
 /**
  * @brief Async task for generating chunk meshes
  */
@@ -24,12 +256,15 @@ class TERRA_SCAPE_API FTS_AsyncMeshGenerationTask : public FNonAbandonableTask
 public:
 	FTS_AsyncMeshGenerationTask(
 		const FIntVector& InChunkID,
-		const TArray<FTS_Voxel>& InVoxelData,
+		const FTS_ChunkVoxelSnapshot& InVoxelData,
 		int32 InChunkSize,
 		float InVoxelSize,
 		const FVector& InChunkWorldPos,
 		UTS_MaterialManager* InMaterialManager,
-		int32 InLODLevel = 0
+		int32 InLODLevel = 0,
+		ETS_MeshingMode InMeshingMode = ETS_MeshingMode::Greedy,
+		FTS_ChunkApron&& InApron = FTS_ChunkApron(),
+		bool bInCollisionOnly = false
 	)
 		: ChunkID(InChunkID)
 		, VoxelData(InVoxelData)
@@ -38,17 +273,29 @@ public:
 		, ChunkWorldPos(InChunkWorldPos)
 		, MaterialManager(InMaterialManager)
 		, LODLevel(InLODLevel)
+		, MeshingMode(InMeshingMode)
+		, Apron(MoveTemp(InApron))
+		, bCollisionOnly(bInCollisionOnly)
 	{
 	}
 
+	/** Largest grid that can be meshed: a column plus its two apron cells must fit in one 64-bit word */
+	static constexpr int32 MaxGridSize = 62;
+
+	/** LOD the mesh was built at */
+	FORCEINLINE int32 GetLODLevel() const { return LODLevel; }
+
 	// FNonAbandonableTask interface
 	void DoWork();
 	FORCEINLINE TStatId GetStatId() const
 	{
-		RETURN_QUICK_DECLARE_CYCLE_STAT(FTS_AsyncMeshGenerationTask, STATGROUP_ThreadPoolAsyncTasks);
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FTS_AsyncMeshGenerationTask, STATGROUP_TerraScape);
 	}
 
-	// Results
+	/** Reports the finished task to the chunk manager */
+	FTS_ChunkTaskContext Context;
+
+	// Results (Normals, UVs, Colors and MaterialInterface stay empty for collision-only meshes)
 	TArray<FVector> Vertices;
 	TArray<int32> Triangles;
 	TArray<FVector> Normals;
@@ -56,18 +303,200 @@ public:
 	TArray<FColor> Colors;
 	UMaterialInterface* MaterialInterface = nullptr;
 
+	/** Time spent building the mesh (excluding setup), for comparing meshing modes */
+	double BuildTimeMs = 0.0;
+
 private:
 	FIntVector ChunkID;
-	TArray<FTS_Voxel> VoxelData;
+
+	/** Shared with the chunk manager; an edit while this task runs copies the storage instead */
+	FTS_ChunkVoxelSnapshot VoxelData;
 	int32 ChunkSize;
 	float VoxelSize;
 	FVector ChunkWorldPos;
 	UTS_MaterialManager* MaterialManager;
 	int32 LODLevel;
+	ETS_MeshingMode MeshingMode;
+	FTS_ChunkApron Apron;
+
+	/** Build positions and triangles only; faces of different materials merge as well */
+	bool bCollisionOnly;
+
+	/** Cells per axis of the LOD grid being meshed (at most MaxGridSize) and voxels per cell */
+	int32 GridSize = 0;
+	int32 GridStep = 1;
+
+	/** Mip level of VoxelData matching the LOD grid, nullptr when the mips are missing and cells are point-sampled */
+	const FTS_ChunkVoxelStorage* CellData = nullptr;
+
+	/**
+	 * Solidity bitmask padded with the apron, one word per column of a (GridSize + 2)^2 grid
+	 * Column (X + 1) + (Y + 1) * (GridSize + 2) holds cell column (X, Y); bit Z + 1 is cell Z,
+	 * bits 0 and GridSize + 1 are the apron below and above
+	 */
+	TArray<uint64> SolidColumns;
+
+	/** Visible faces per direction (+X, -X, +Y, -Y, +Z, -Z), bit Z of column X + Y * GridSize */
+	TArray<uint64> FaceColumns[6];
 
 	void GenerateChunkMesh();
-	FTS_Voxel GetVoxelAt(int32 X, int32 Y, int32 Z) const;
-	bool IsVoxelSolid(int32 X, int32 Y, int32 Z) const;
+
+	/** Pack cell and apron solidity into one 64-bit word per padded column, returns the number of solid cells */
+	int32 BuildSolidColumns();
+
+	/** Find visible faces for all six directions with shifts and AND-NOT on whole columns */
+	void BuildFaceColumns();
+
+	/** Emit one quad per visible face bit */
+	void GenerateNaiveMesh(int32 VisibleFaces, const FColor& VertexColor);
+
+	/** Merge visible faces of each slice into maximal same-material rectangles */
+	void GenerateGreedyMesh(const FColor& VertexColor);
+
+	/** Append the quad of a box face (FaceIndex: +X, -X, +Y, -Y, +Z, -Z) */
+	void AddFaceQuad(int32 FaceIndex, const FVector& BoxMin, const FVector& BoxMax, const FColor& VertexColor);
+
+	/** Material of a cell of the LOD grid */
+	int32 GetCellMaterial(int32 X, int32 Y, int32 Z) const;
+};
+
+/**
+ * @brief Everything the chunk manager tracks for one loaded chunk
+ * Kept in a single slot of the chunk table, so a chunk's state, voxels, mesh and tasks are found
+ * with one lookup and its neighbours through Neighbors without hashing their IDs.
+ */
+struct FTS_ChunkRecord
+{
+	FIntVector ChunkID = FIntVector::ZeroValue;
+
+	/** World position of this chunk */
+	FVector WorldPosition = FVector::ZeroVector;
+
+	/** Whether every voxel of this chunk has the same material (stored as a single value, see IsMeshable) */
+	bool bIsUniform = false;
+
+	/** Material of every voxel when bIsUniform is set (0 = air) */
+	int32 UniformMaterialID = 0;
+
+	/** Paletted voxel data, empty while generating or when uniform; shared read-only with mesh tasks */
+	FTS_ChunkVoxelStoragePtr VoxelData;
+
+	/** Mesh component, created on the first non-empty mesh */
+	UProceduralMeshComponent* Mesh = nullptr;
+
+	/** Bytes of mesh data last uploaded to the component (positions, indices and attributes) */
+	int64 MeshBytes = 0;
+
+	/** When the chunk was created, cleared once it first has a mesh (or turns out uniform) */
+	double RequestTime = 0.0;
+
+	/** LOD the chunk is being meshed at, INDEX_NONE until its first mesh task starts */
+	int32 LODLevel = INDEX_NONE;
+
+	/** LOD of the mesh on screen, INDEX_NONE until the first upload; neighbours sample this one */
+	int32 RenderedLODLevel = INDEX_NONE;
+
+	/** Apron signature (loaded neighbours and their LODs) the current mesh was built with */
+	uint32 ApronSignature = 0;
+	bool bHasApronSignature = false;
+
+	/** Running voxel generation and mesh tasks, and a finished mesh waiting for upload */
+	FAsyncTask<FTS_AsyncVoxelGenerationTask>* GenerationTask = nullptr;
+	FAsyncTask<FTS_AsyncMeshGenerationTask>* MeshTask = nullptr;
+	FAsyncTask<FTS_AsyncMeshGenerationTask>* ReadyMeshTask = nullptr;
+
+	/** Voxels have edits the region files don't hold yet; cleared once a save of them is written */
+	bool bModified = false;
+
+	/** The region store holds the current voxels */
+	bool bStored = false;
+
+	/** Serial of the save in flight for the current voxels, 0 when none is */
+	uint32 SaveSerial = 0;
+
+	/** Chunk table indices of the face neighbours (+X, -X, +Y, -Y, +Z, -Z), INDEX_NONE when not loaded */
+	int32 Neighbors[6] = { INDEX_NONE, INDEX_NONE, INDEX_NONE, INDEX_NONE, INDEX_NONE, INDEX_NONE };
+
+	/** Whether the voxel data (array or uniform value) is available */
+	FORCEINLINE bool HasVoxelData() const { return bIsUniform || VoxelData.IsValid(); }
+
+	/** Whether the chunk can have a mesh: it has voxel storage, or is uniformly solid and may show its border */
+	FORCEINLINE bool IsMeshable() const { return VoxelData.IsValid() || (bIsUniform && UniformMaterialID > 0); }
+};
+
+/**
+ * @brief An actor chunks are streamed around, with its own volume and scheduling weight
+ * Servers register one per player; overlapping volumes share their chunks.
+ */
+USTRUCT(BlueprintType)
+struct TERRA_SCAPE_API FTS_StreamingObserver
+{
+	GENERATED_BODY()
+
+	/** Actor whose position drives streaming, LOD and scheduling (usually a player pawn) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Streaming")
+	TWeakObjectPtr<AActor> Actor;
+
+	/** Horizontal streaming radius in chunks */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Streaming")
+	int32 RadiusXY = 8;
+
+	/** Vertical streaming radius in chunks */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Streaming")
+	int32 RadiusZ = 2;
+
+	/** Queued work near an observer with weight 2 runs as if it were half as far away */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Streaming")
+	float PriorityWeight = 1.0f;
+
+	/** Chunk and radii the observer's volume was last built for (runtime state) */
+	FIntVector StreamingCenter = FIntVector::ZeroValue;
+	FIntPoint StreamingRadius = FIntPoint::ZeroValue;
+	bool bHasStreamingCenter = false;
+
+	/** Next offset of the volume to request, restarts when the volume moves */
+	int32 LoadCursor = 0;
+};
+
+/**
+ * @brief Game-thread cost of applying finished meshes to their components, and how long chunks take to appear
+ */
+USTRUCT(BlueprintType)
+struct TERRA_SCAPE_API FTS_MeshUploadStats
+{
+	GENERATED_BODY()
+
+	/** Time spent uploading meshes in the last tick that had any */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "TerraScape | Performance")
+	float LastUploadMs = 0.0f;
+
+	/** Meshes uploaded in the last tick that had any */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "TerraScape | Performance")
+	int32 LastUploadCount = 0;
+
+	/** Longest upload tick since the stats were reset */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "TerraScape | Performance")
+	float PeakUploadMs = 0.0f;
+
+	/** Most expensive single mesh upload since the stats were reset */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "TerraScape | Performance")
+	float PeakMeshUploadMs = 0.0f;
+
+	/** Finished meshes waiting for their upload */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "TerraScape | Performance")
+	int32 PendingUploads = 0;
+
+	/** Meshes uploaded since the stats were reset */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "TerraScape | Performance")
+	int32 TotalUploads = 0;
+
+	/** Time from creating the last chunk that got its first mesh to that mesh's upload */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "TerraScape | Performance")
+	float LastChunkLatencyMs = 0.0f;
+
+	/** Longest chunk latency since the stats were reset */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "TerraScape | Performance")
+	float PeakChunkLatencyMs = 0.0f;
 };
 
 /**
@@ -78,15 +507,21 @@ class TERRA_SCAPE_API UTS_ChunkManager : public UActorComponent
 {
 	GENERATED_BODY()
 
+	friend class FTS_ChunkVoxelEditTest;
+	friend class FTS_UniformChunkBorderTest;
+	friend class FTS_StreamingDeleteTest;
+
 public:
 	UTS_ChunkManager();
 
 protected:
+	virtual void BeginPlay() override;
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
-	/** Chunk size (32x32x32 voxels for streaming - balanced performance and memory) */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Chunk Settings")
+	/** Chunk size (32x32x32 voxels for streaming - balanced performance and memory), at most 62 so LOD 0 can be meshed */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Chunk Settings", meta = (ClampMin = 1, ClampMax = 62))
 	int32 ChunkSize = 32;
 
 	/** Size of each voxel in world units (e.g., 100 = 100cm per voxel) */
@@ -104,6 +539,13 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Procedural")
 	UTS_WorldGenerator* WorldGenerator;
 
+	/**
+	 * World generation settings applied to WorldGenerator in BeginPlay; the bake commandlet reads the same
+	 * asset, so baked and runtime-generated chunks match. Unset keeps the generator's own parameters.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Procedural")
+	UTS_WorldGenParametersAsset* WorldGenParameters = nullptr;
+
 	/** Enable procedural generation instead of test voxels */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Procedural")
 	bool bUseProceduralGeneration = true;
@@ -112,15 +554,67 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Materials")
 	UDataTable* MaterialDataTable;
 
-	/** Async mesh generation tasks */
-	TMap<FIntVector, FAsyncTask<FTS_AsyncMeshGenerationTask>*> AsyncMeshTasks;
+	/** Completion notices pushed by the workers, shared with every task */
+	TSharedPtr<FTS_ChunkTaskCompletionQueue, ESPMode::ThreadSafe> CompletionQueue;
+
+	/** Serial handed to the next task, 0 is never used */
+	uint32 NextTaskSerial = 1;
+
+	/** Superseded tasks that were already running, cancelled and deleted once they report in (by serial) */
+	TMap<uint32, FAsyncTask<FTS_AsyncVoxelGenerationTask>*> RetiredGenerationTasks;
+	TMap<uint32, FAsyncTask<FTS_AsyncMeshGenerationTask>*> RetiredMeshTasks;
+
+	/** Order of the finished meshes waiting for the game thread to upload them, nearest and in view first */
+	FTS_ChunkScheduler UploadScheduler;
 
-	/** Queue of chunks waiting for mesh generation when async task limit is reached */
-	TArray<FIntVector> PendingMeshGenerationQueue;
+	/** Chunks waiting for voxel generation when async task limit is reached, nearest and in view first */
+	FTS_ChunkScheduler GenerationScheduler;
 
-	/** Maximum number of concurrent async tasks to prevent thread pool exhaustion */
+	/** Chunks waiting for mesh generation when async task limit is reached, nearest and in view first */
+	FTS_ChunkScheduler MeshScheduler;
+
+	/** Maximum number of concurrent async tasks (generation + meshing), 0 for one per worker thread */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Performance")
+	int32 MaxConcurrentAsyncTasks = 0;
+
+	/** Threads in the TerraScape worker pool, 0 for one per physical core (read when the pool starts) */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Performance")
-	int32 MaxConcurrentAsyncTasks = 8;
+	int32 WorkerThreadCount = 0;
+
+	/** Priority of the worker threads (read when the pool starts) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Performance")
+	ETS_WorkerThreadPriority WorkerThreadPriority = ETS_WorkerThreadPriority::BelowNormal;
+
+	/** Bit mask of the cores the worker threads may run on, 0 for any (read when the pool starts) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Performance")
+	int64 WorkerAffinityMask = 0;
+
+	/** Meshing algorithm; greedy merges coplanar faces for far fewer vertices and cheaper collision */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Performance")
+	ETS_MeshingMode MeshingMode = ETS_MeshingMode::Greedy;
+
+	/**
+	 * Game-thread time per tick for uploading finished meshes (milliseconds, 0 = no limit)
+	 * At least one mesh is uploaded every tick, the rest wait for the next one.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Performance")
+	float MeshUploadBudgetMs = 2.0f;
+
+	/** Mesh components created up front in BeginPlay, so the first chunks don't allocate any */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Performance")
+	int32 MeshComponentPoolWarmUp = 64;
+
+	/** Most idle mesh components kept for reuse; components released beyond this are destroyed */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Performance")
+	int32 MeshComponentPoolMaxSize = 512;
+
+	/** Whether chunks get render meshes or only collision (servers don't need normals, UVs or materials) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Performance")
+	ETS_ChunkMeshContent MeshContent = ETS_ChunkMeshContent::Auto;
+
+	/** Angle of the view cone (degrees) whose chunks are generated and meshed before those behind the player */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Performance")
+	float SchedulingViewAngle = 120.0f;
 
 	/** LOD (Level of Detail) settings */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | LOD")
@@ -136,16 +630,74 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | LOD")
 	float LOD2Distance = 8000.0f; // Minimal detail
 
+	/** How voxels are merged into the coarser mip levels that LOD 1-3 meshes are built from */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | LOD")
+	ETS_LODReduction LODReduction = ETS_LODReduction::Majority;
+
 	/** Player reference for distance calculations */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | LOD")
 	AActor* PlayerReference;
 
+	/** Keep chunks loaded in a volume around each observer (and PlayerReference), loading and unloading as they move */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Streaming")
+	bool bEnableStreaming = true;
+
+	/** Registered observers; chunks inside any of their volumes stay loaded */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "TerraScape | Streaming")
+	TArray<FTS_StreamingObserver> StreamingObservers;
+
+	/** Horizontal streaming radius in chunks around PlayerReference (a circle around its chunk) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Streaming")
+	int32 StreamingRadiusXY = 8;
+
+	/** Vertical streaming radius in chunks above and below PlayerReference's chunk */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Streaming")
+	int32 StreamingRadiusZ = 2;
+
+	/** Extra chunks beyond the radius before a chunk is unloaded, so walking along a border doesn't thrash */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Streaming")
+	int32 StreamingHysteresis = 2;
+
+	/** Chunks requested per tick at most, nearest first */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Streaming")
+	int32 MaxChunkLoadsPerTick = 16;
+
+	/** Chunks unloaded per tick at most, farthest first */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Streaming")
+	int32 MaxChunkUnloadsPerTick = 16;
+
+	/** Save chunks to region files when they unload, and load saved chunks instead of generating them again */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Persistence")
+	bool bEnablePersistence = false;
+
+	/** Folder under Saved/TerraScape holding this world's region files (one per seed and generator setup) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Persistence")
+	FString WorldSaveName = TEXT("Default");
+
+	/** Save untouched chunks too, so revisiting them skips generation; edited chunks are always saved */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Persistence")
+	bool bPersistGeneratedChunks = true;
+
+	/** Codec of new region files: LZ4 loads fastest, Oodle is smaller (read when the first chunk is stored or loaded) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "TerraScape | Persistence")
+	FName RegionCompressionFormat = NAME_LZ4;
+
 	/** Simple Blueprint functions for MVP testing */
 	UFUNCTION(BlueprintCallable, Category = "TerraScape | Chunks")
 	void CreateChunk(const FIntVector& ChunkID);
 
-	/** Check for completed async mesh generation tasks */
-	void CheckAsyncMeshTasks();
+	/**
+	 * Handle the tasks workers reported as done: hand generated voxels to meshing, queue finished meshes
+	 * for upload and start queued work in the freed slots, then upload as many meshes as the budget allows
+	 */
+	void ProcessCompletedTasks();
+
+	/** Upload cost of recent ticks and the number of meshes waiting */
+	UFUNCTION(BlueprintPure, Category = "TerraScape | Performance")
+	FTS_MeshUploadStats GetMeshUploadStats() const;
+
+	UFUNCTION(BlueprintCallable, Category = "TerraScape | Performance")
+	void ResetMeshUploadStats();
 
 	/** Update LOD for all chunks based on player distance */
 	UFUNCTION(BlueprintCallable, Category = "TerraScape | LOD")
@@ -162,6 +714,29 @@ public:
 	/** Calculate chunk world position (single source of truth) */
 	FVector CalculateChunkWorldPosition(const FIntVector& ChunkID) const;
 
+	/** Chunk whose centre is nearest to a world location (inverse of CalculateChunkWorldPosition) */
+	UFUNCTION(BlueprintCallable, Category = "TerraScape | Streaming")
+	FIntVector GetChunkIDAtLocation(const FVector& WorldLocation) const;
+
+	/** Load chunks entering and unload chunks leaving the streaming volumes of all observers */
+	UFUNCTION(BlueprintCallable, Category = "TerraScape | Streaming")
+	void UpdateStreaming();
+
+	/** Add an observer, or update its settings if already registered */
+	UFUNCTION(BlueprintCallable, Category = "TerraScape | Streaming")
+	void RegisterStreamingObserver(AActor* Actor, int32 RadiusXY = 8, int32 RadiusZ = 2, float PriorityWeight = 1.0f);
+
+	/** Remove an observer; its chunks unload unless another observer still covers them */
+	UFUNCTION(BlueprintCallable, Category = "TerraScape | Streaming")
+	void UnregisterStreamingObserver(AActor* Actor);
+
+	UFUNCTION(BlueprintCallable, Category = "TerraScape | Streaming")
+	bool IsStreamingObserver(const AActor* Actor) const;
+
+	/** True when chunks are built as collision only (MeshContent, resolved for Auto by the net mode) */
+	UFUNCTION(BlueprintPure, Category = "TerraScape | Performance")
+	bool IsCollisionOnly() const;
+
 	/** Generate a grid of chunks around a center point */
 	UFUNCTION(BlueprintCallable, Category = "TerraScape | Bulk Generation")
 	void GenerateChunkGrid(const FIntVector& CenterChunk, int32 GridSize);
@@ -179,24 +754,254 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "TerraScape | Chunks")
 	int32 GetLoadedChunkCount() const;
 
+	/** Bytes of voxel data held by loaded chunks (palettes and packed indices) */
+	UFUNCTION(BlueprintCallable, Category = "TerraScape | Chunks")
+	int64 GetVoxelMemoryUsage() const;
+
+	/** Bytes of mesh data uploaded to chunk mesh components */
+	UFUNCTION(BlueprintCallable, Category = "TerraScape | Chunks")
+	int64 GetMeshMemoryUsage() const;
+
+	/** Whether chunks of this size can be meshed at full detail */
+	static bool IsValidChunkSize(int32 InChunkSize);
+
+	/** Folder of a saved world's region files (Saved/TerraScape/<WorldSaveName>) */
+	static FString GetWorldSaveDirectory(const FString& InWorldSaveName);
+
+	/** Copy the WorldGenParameters asset (if set) into the world generator */
+	void ApplyWorldGenParameters();
+
+	/**
+	 * Hash of the generator settings and chunk layout (voxel size, gap) that stored chunks depend on
+	 * Region files record it and are ignored when it doesn't match, so stored and generated chunks never mix.
+	 */
+	uint32 GetGeneratorFingerprint() const;
+
+	/** Queue a save of every loaded chunk the region files don't have yet (edited or, optionally, generated) */
+	UFUNCTION(BlueprintCallable, Category = "TerraScape | Persistence")
+	void SaveAllChunks();
+
+	/** Idle mesh components waiting for reuse */
+	UFUNCTION(BlueprintPure, Category = "TerraScape | Performance")
+	int32 GetPooledMeshComponentCount() const;
+
+	/** Most mesh components that existed at once (in use plus idle) */
+	UFUNCTION(BlueprintPure, Category = "TerraScape | Performance")
+	int32 GetMeshComponentHighWaterMark() const;
+
+	/** Fill the component pool up to MeshComponentPoolWarmUp */
+	UFUNCTION(BlueprintCallable, Category = "TerraScape | Performance")
+	void WarmUpMeshComponentPool();
+
+	/** Destroy every idle mesh component */
+	UFUNCTION(BlueprintCallable, Category = "TerraScape | Performance")
+	void EmptyMeshComponentPool();
+
+	/**
+	 * Change one voxel of a loaded chunk and queue the remesh
+	 * Chunks overlap when ChunkGap is negative, so every loaded chunk holding the same world voxel is
+	 * changed too, and the chunks whose apron reads it are remeshed. Each chunk's storage is copied
+	 * first only if a mesh task still holds the current version.
+	 * @return False if the position is out of range or a loaded chunk holding the voxel has no voxel data yet
+	 */
+	UFUNCTION(BlueprintCallable, Category = "TerraScape | Chunks")
+	bool SetVoxelAt(const FIntVector& ChunkID, int32 X, int32 Y, int32 Z, int32 MaterialID);
+
 private:
-	/** Simple map to store loaded chunks */
-	TMap<FIntVector, FTS_Chunk> LoadedChunks;
+	/** One record per loaded chunk: state, voxel data, mesh, LOD and tasks */
+	TTS_ChunkTable<FTS_ChunkRecord> ChunkRecords;
+
+	/** Running tasks held by records (retired ones are counted separately) */
+	int32 NumGenerationTasks = 0;
+	int32 NumMeshTasks = 0;
+
+	/** Chunks that have a mesh component */
+	int32 NumChunkMeshes = 0;
+
+	/** Sum of the records' MeshBytes */
+	int64 MeshMemoryBytes = 0;
+
+	/** Publish chunk counts, queue depths and memory to STATGROUP_TerraScape */
+	void UpdateStats();
+
+	/** Region files of WorldSaveName, opened on first use; null while persistence is off */
+	TSharedPtr<FTS_RegionStore, ESPMode::ThreadSafe> RegionStore;
+
+	TSharedPtr<FTS_RegionStore, ESPMode::ThreadSafe> GetRegionStore();
+
+	/** Queue a save of a chunk if the region files don't have its current voxels, returns true if queued */
+	bool SaveChunk(FTS_ChunkRecord& Record);
+
+	/** Mark chunks whose save was written as stored; a failed one stays modified for the next save */
+	void ProcessSaveResults();
+
+	/** Retire a chunk's running voxel generation or mesh task, if any */
+	void CancelGenerationTask(FTS_ChunkRecord& Record);
+	void CancelMeshTask(FTS_ChunkRecord& Record);
+
+	/** Idle mesh components, registered and hidden, waiting to be handed to a chunk */
+	UPROPERTY(Transient)
+	TArray<UProceduralMeshComponent*> MeshComponentPool;
+
+	/** Most mesh components in use and idle at once */
+	int32 MeshComponentHighWaterMark = 0;
+
+	/** Take an idle mesh component from the pool, creating one if it's empty */
+	UProceduralMeshComponent* AcquireMeshComponent();
+
+	/** Clear a chunk's mesh component and return it to the pool (or destroy it once the pool is full) */
+	void ReleaseMeshComponent(UProceduralMeshComponent* MeshComp);
+
+	/** Create, register and attach a hidden mesh component */
+	UProceduralMeshComponent* CreatePooledMeshComponent();
+
+	/** Mip levels built per chunk, one for each coarse LOD (LOD 1-3 use the 1/2, 1/4 and 1/8 resolution mips) */
+	static constexpr int32 NumLODMipLevels = 3;
+
+	/** Copy the one-voxel border of a chunk from its loaded neighbours */
+	FTS_ChunkApron BuildChunkApron(const FTS_ChunkRecord& Record) const;
+
+	/** Queue a remesh of every neighbour whose mesh was built before this chunk's data or LOD changed */
+	void RemeshNeighborsOfChunk(const FTS_ChunkRecord& Record);
 
-	/** Simple map to store voxel data per chunk */
-	TMap<FIntVector, TArray<FTS_Voxel>> ChunkVoxelData;
+	/**
+	 * LOD of the chunk's mesh on screen, 0 for uniform chunks since every LOD looks the same
+	 * Before the first upload this is the LOD it's being meshed at; the upload remeshes neighbours that guessed wrong.
+	 */
+	int32 GetRenderedLODLevel(const FTS_ChunkRecord& Record) const;
 
-	/** Map to store mesh components for each chunk */
-	TMap<FIntVector, UProceduralMeshComponent*> ChunkMeshes;
+	/** Material of the LOD cell covering a local voxel position, air outside the chunk */
+	int32 GetRenderedMaterial(const FTS_ChunkRecord& Record, const FIntVector& LocalPos, int32 LODLevel) const;
 
-	/** Map to store current LOD level for each chunk */
-	TMap<FIntVector, int32> ChunkLODLevels;
+	/** Distance between neighbouring chunk origins in voxels (chunks overlap when ChunkGap is negative) */
+	int32 GetChunkStrideVoxels() const;
 
-	/** Generate simple test voxels for a chunk */
-	TArray<FTS_Voxel> GenerateTestVoxels(const FIntVector& ChunkID);
+	/** Write one voxel into a chunk with voxel data, copying or expanding its storage as needed; true if it changed */
+	bool SetRecordVoxel(FTS_ChunkRecord& Record, const FIntVector& LocalPos, int32 MaterialID);
 
-	/** Generate procedural voxel data for a chunk */
-	TArray<FTS_Voxel> GenerateProceduralVoxels(const FIntVector& ChunkID);
+	/** Get the mesh component of a chunk, creating it on first use (air chunks never get one) */
+	UProceduralMeshComponent* GetOrCreateChunkMesh(FTS_ChunkRecord& Record);
+
+	/** Start async voxel generation for a chunk */
+	void StartVoxelGeneration(const FIntVector& ChunkID);
+
+	/** Start async mesh generation for a chunk that has voxel data, or only the open border of a solid uniform one */
+	void StartMeshGeneration(const FIntVector& ChunkID);
+
+	/** Start queued generation and mesh work while task slots are available */
+	void ProcessPendingQueues();
+
+	/** Store a chunk's generated voxels and queue it for meshing */
+	void CompleteVoxelGeneration(FTS_ChunkRecord& Record, FTS_AsyncVoxelGenerationTask& TaskResult);
+
+	/** Upload ready meshes, most urgent first, until MeshUploadBudgetMs is spent */
+	void UploadReadyMeshes();
+
+	/** Set up a task to report its completion, returns its serial */
+	uint32 InitTaskContext(FTS_ChunkTaskContext& Context);
+
+	/**
+	 * Drop a task without blocking: deleted right away if it hasn't started, otherwise flagged as
+	 * cancelled and kept in Retired until its completion notice arrives
+	 */
+	template<typename TaskType>
+	void RetireTask(FAsyncTask<TaskType>* Task, TMap<uint32, FAsyncTask<TaskType>*>& Retired)
+	{
+		Task->GetTask().Context.Cancel();
+		if (Task->Cancel())
+		{
+			delete Task; // Never started, DoWork won't run
+			return;
+		}
+		Retired.Add(Task->GetTask().Context.TaskSerial, Task);
+	}
+
+	/** Wait for and delete retired tasks (they stop at their next cancellation check) */
+	template<typename TaskType>
+	static void WaitForRetiredTasks(TMap<uint32, FAsyncTask<TaskType>*>& Retired)
+	{
+		for (auto& TaskPair : Retired)
+		{
+			TaskPair.Value->EnsureCompletion();
+			delete TaskPair.Value;
+		}
+		Retired.Empty();
+	}
+
+	/** Apply a finished mesh to the chunk's component, creating it on the first non-empty mesh */
+	void UploadChunkMesh(FTS_ChunkRecord& Record, FTS_AsyncMeshGenerationTask& TaskResult);
+
+	/** Drop a finished mesh that hasn't been uploaded yet */
+	void DiscardReadyMesh(FTS_ChunkRecord& Record);
+
+	FTS_MeshUploadStats MeshUploadStats;
+
+	/** Observer position and view direction for ranking queued work */
+	FTS_ChunkSchedulerView GetSchedulerView() const;
+
+	/** Number of async tasks currently in flight (generation + meshing) */
+	int32 GetNumAsyncTasks() const;
+
+	/** MaxConcurrentAsyncTasks, or the worker count when it is 0 */
+	int32 GetMaxConcurrentAsyncTasks() const;
+
+	/** Threads chunk tasks run on; started on first use and stopped in EndPlay */
+	FTS_WorkerPool WorkerPool;
+
+	/** The worker pool couldn't be started; tasks use GThreadPool until EndPlay rather than retrying per task */
+	bool bWorkerPoolFailed = false;
+
+	/** The worker pool, starting it if needed (falls back to GThreadPool if it can't be created) */
+	FQueuedThreadPool* GetTaskThreadPool();
+
+	/** PlayerReference as an observer with the manager's streaming radii, unless registered explicitly */
+	FTS_StreamingObserver PlayerObserver;
+
+	/** Observer count the unload list was built for */
+	int32 NumStreamingObservers = 0;
+
+	/** Offsets inside a streaming volume, nearest first, per (RadiusXY, RadiusZ) */
+	TMap<FIntPoint, TArray<FIntVector>> StreamingOffsetsByRadius;
+
+	/** Loaded chunks outside every volume, nearest first so the farthest is popped first */
+	TArray<FIntVector> StreamingUnloadList;
+
+	/** A chunk was created outside streaming (e.g. CreateChunk from gameplay), so the unload list is stale */
+	bool bStreamingUnloadListDirty = false;
+
+	/** Offsets of a streaming volume, built on first use */
+	const TArray<FIntVector>& GetStreamingOffsets(const FIntPoint& Radius);
+
+	/**
+	 * Whether a chunk is inside any observer's streaming volume, widened by Margin chunks
+	 * @param OutNearestDistanceSq - If set, receives the squared chunk distance to the nearest observer's centre
+	 * (only complete when this returns false, the search stops at the first volume containing the chunk)
+	 */
+	bool IsInStreamingVolume(const FIntVector& ChunkID, TArrayView<FTS_StreamingObserver* const> Observers, int32 Margin,
+		int64* OutNearestDistanceSq = nullptr) const;
+
+	/**
+	 * Rescan the volume of every observer containing a chunk, so a chunk deleted inside it is requested again
+	 * (the observer's LoadCursor is already past it otherwise)
+	 */
+	void RestartStreamingAround(const FIntVector& ChunkID);
+
+	/** Call Func(Observer, Actor) for every observer with a live actor, PlayerReference included */
+	template<typename FuncType>
+	void ForEachObserver(FuncType&& Func) const
+	{
+		for (const FTS_StreamingObserver& Observer : StreamingObservers)
+		{
+			if (const AActor* Actor = Observer.Actor.Get())
+			{
+				Func(Observer, *Actor);
+			}
+		}
+		if (PlayerReference && !IsStreamingObserver(PlayerReference))
+		{
+			Func(PlayerObserver, *PlayerReference);
+		}
+	}
 
 	/** Enable or disable procedural generation */
 	void SetProceduralGenerationEnabled(bool bEnabled);
@@ -204,9 +1009,6 @@ private:
 	/** Get world generator instance */
 	UTS_WorldGenerator* GetWorldGenerator() const;
 
-	/** Generate mesh for a chunk with face culling */
-	void GenerateChunkMesh(const FIntVector& ChunkID);
-
 	/** Get voxel at local position within chunk */
 	FTS_Voxel GetVoxelAt(const FIntVector& ChunkID, int32 X, int32 Y, int32 Z) const;
 
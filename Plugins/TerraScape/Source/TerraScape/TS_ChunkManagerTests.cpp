@@ -0,0 +1,168 @@
+/**
+ * @file TS_ChunkManagerTests.cpp
+ * @brief Automation tests for the TerraScape chunk manager
+ * @author Keves
+ * @version 1.0
+ */
+
+#include "TS_ChunkManager.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTS_ChunkVoxelEditTest, "TerraScape.ChunkManager.VoxelEditOverlap",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * With the default layout (32-voxel chunks every 16 voxels) a world voxel lives in several chunks;
+ * an edit through one of them must show through every loaded copy
+ */
+bool FTS_ChunkVoxelEditTest::RunTest(const FString& Parameters)
+{
+	UTS_ChunkManager* ChunkManager = NewObject<UTS_ChunkManager>(GetTransientPackage());
+	ChunkManager->ChunkSize = 32;
+	ChunkManager->VoxelSize = 100.0f;
+	ChunkManager->ChunkGap = -1600.0f;
+	if (!TestEqual(TEXT("Chunk stride is half a chunk"), ChunkManager->GetChunkStrideVoxels(), 16))
+	{
+		return false;
+	}
+
+	// Loaded chunks stand in for generated ones; (1,-1,0) is uniform air, (2,0,0) doesn't hold the voxel
+	auto AddChunk = [ChunkManager](const FIntVector& ChunkID, bool bUniform)
+	{
+		FTS_ChunkRecord& Record = ChunkManager->ChunkRecords[ChunkManager->ChunkRecords.Add(ChunkID)];
+		Record.bIsUniform = bUniform;
+		if (!bUniform)
+		{
+			Record.VoxelData = MakeShared<FTS_ChunkVoxelStorage, ESPMode::ThreadSafe>(ChunkManager->ChunkSize, 0);
+		}
+		return ChunkID;
+	};
+	const FIntVector EditedChunk = AddChunk(FIntVector(0, 0, 0), false);
+	const FIntVector FaceChunk = AddChunk(FIntVector(1, 0, 0), false);
+	const FIntVector DiagonalChunk = AddChunk(FIntVector(1, -1, 0), true);
+	const FIntVector OtherChunk = AddChunk(FIntVector(2, 0, 0), false);
+
+	// World voxel (20,5,5): local (4,5,5) of chunk (1,0,0) and (4,21,5) of chunk (1,-1,0)
+	TestTrue(TEXT("Edit succeeds"), ChunkManager->SetVoxelAt(EditedChunk, 20, 5, 5, 3));
+	TestEqual(TEXT("Edited chunk holds the new material"), ChunkManager->GetVoxelAt(EditedChunk, 20, 5, 5).MaterialID, 3);
+	TestEqual(TEXT("Overlapping face neighbour holds the new material"), ChunkManager->GetVoxelAt(FaceChunk, 4, 5, 5).MaterialID, 3);
+	TestEqual(TEXT("Overlapping diagonal chunk holds the new material"), ChunkManager->GetVoxelAt(DiagonalChunk, 4, 21, 5).MaterialID, 3);
+	TestTrue(TEXT("Every copy is marked modified"), ChunkManager->ChunkRecords.Find(EditedChunk)->bModified
+		&& ChunkManager->ChunkRecords.Find(FaceChunk)->bModified && ChunkManager->ChunkRecords.Find(DiagonalChunk)->bModified);
+	TestFalse(TEXT("A chunk not holding the voxel is untouched"), ChunkManager->ChunkRecords.Find(OtherChunk)->bModified);
+
+	// A copy still generating would come back with the old material, so the edit is refused as a whole
+	ChunkManager->ChunkRecords.Add(FIntVector(0, -1, 0));
+	TestFalse(TEXT("Edit is refused while a copy is generating"), ChunkManager->SetVoxelAt(FaceChunk, 4, 5, 5, 4));
+	TestEqual(TEXT("Refused edit changes no copy"), ChunkManager->GetVoxelAt(EditedChunk, 20, 5, 5).MaterialID, 3);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTS_UniformChunkBorderTest, "TerraScape.ChunkManager.UniformChunkBorder",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * A solid uniform chunk next to an open neighbour must build the wall between them, neither chunk
+ * would otherwise emit it; once every loaded neighbour is solid there is nothing to mesh
+ */
+bool FTS_UniformChunkBorderTest::RunTest(const FString& Parameters)
+{
+	UTS_ChunkManager* ChunkManager = NewObject<UTS_ChunkManager>(GetTransientPackage());
+	ChunkManager->ChunkSize = 8;
+	ChunkManager->VoxelSize = 100.0f;
+	ChunkManager->ChunkGap = 0.0f;
+	ChunkManager->MeshContent = ETS_ChunkMeshContent::RenderAndCollision;
+	ChunkManager->MeshingMode = ETS_MeshingMode::Greedy;
+
+	// Solid uniform chunk with an all-air chunk on +X, a solid uniform one on -X and nothing loaded elsewhere
+	const FIntVector SolidChunk(0, 0, 0);
+	const FIntVector OpenChunk(1, 0, 0);
+	auto AddChunk = [ChunkManager](const FIntVector& ChunkID, bool bUniform)
+	{
+		FTS_ChunkRecord& Record = ChunkManager->ChunkRecords[ChunkManager->ChunkRecords.Add(ChunkID)];
+		Record.bIsUniform = bUniform;
+		if (bUniform)
+		{
+			Record.UniformMaterialID = 1;
+		}
+		else
+		{
+			Record.VoxelData = MakeShared<FTS_ChunkVoxelStorage, ESPMode::ThreadSafe>(ChunkManager->ChunkSize, 0);
+		}
+	};
+	AddChunk(SolidChunk, true);
+	AddChunk(FIntVector(-1, 0, 0), true);
+	AddChunk(OpenChunk, false);
+
+	ChunkManager->StartMeshGeneration(SolidChunk);
+	FTS_ChunkRecord* Record = ChunkManager->ChunkRecords.Find(SolidChunk);
+	if (!TestNotNull(TEXT("Solid uniform chunk next to an open one is meshed"), Record->MeshTask))
+	{
+		ChunkManager->WorkerPool.Stop();
+		return false;
+	}
+
+	Record->MeshTask->EnsureCompletion();
+	const TArray<FVector>& Vertices = Record->MeshTask->GetTask().Vertices;
+	const float BorderX = ChunkManager->ChunkSize * ChunkManager->VoxelSize;
+	TestTrue(TEXT("The wall facing the open chunk is built"), Vertices.Num() > 0);
+	TestTrue(TEXT("Only the wall facing the open chunk is built"),
+		!Vertices.ContainsByPredicate([BorderX](const FVector& Vertex) { return !FMath::IsNearlyEqual(Vertex.X, BorderX); }));
+	ChunkManager->CancelMeshTask(*Record);
+	ChunkManager->WaitForRetiredTasks(ChunkManager->RetiredMeshTasks);
+
+	// Filling the neighbour closes the border
+	ChunkManager->ChunkRecords.Find(OpenChunk)->VoxelData->Init(ChunkManager->ChunkSize, 2);
+	ChunkManager->StartMeshGeneration(SolidChunk);
+	TestNull(TEXT("Solid uniform chunk with only solid neighbours isn't meshed"), Record->MeshTask);
+	TestTrue(TEXT("Skipped chunk still records what it was checked against"), Record->bHasApronSignature);
+
+	ChunkManager->WorkerPool.Stop();
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTS_StreamingDeleteTest, "TerraScape.ChunkManager.StreamingDelete",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * A stationary observer whose volume is fully requested must come back for a chunk deleted inside it,
+ * and an observer elsewhere keeps its place
+ */
+bool FTS_StreamingDeleteTest::RunTest(const FString& Parameters)
+{
+	UTS_ChunkManager* ChunkManager = NewObject<UTS_ChunkManager>(GetTransientPackage());
+
+	// Observers that already walked their whole volume and never move
+	auto AddObserver = [ChunkManager](const FIntVector& Center)
+	{
+		FTS_StreamingObserver& Observer = ChunkManager->StreamingObservers.AddDefaulted_GetRef();
+		Observer.StreamingCenter = Center;
+		Observer.StreamingRadius = FIntPoint(2, 1);
+		Observer.bHasStreamingCenter = true;
+		Observer.LoadCursor = ChunkManager->GetStreamingOffsets(Observer.StreamingRadius).Num();
+	};
+	AddObserver(FIntVector(0, 0, 0));
+	AddObserver(FIntVector(100, 0, 0));
+	const int32 NumOffsets = ChunkManager->StreamingObservers[0].LoadCursor;
+
+	const FIntVector DeletedChunk(1, 1, 0);
+	ChunkManager->ChunkRecords[ChunkManager->ChunkRecords.Add(DeletedChunk)].bIsUniform = true;
+	ChunkManager->DeleteChunk(DeletedChunk);
+	TestFalse(TEXT("Chunk is deleted"), ChunkManager->IsChunkLoaded(DeletedChunk));
+
+	// The next streaming pass walks the volume from LoadCursor and requests every missing chunk
+	const FTS_StreamingObserver& Near = ChunkManager->StreamingObservers[0];
+	const TArray<FIntVector>& Offsets = ChunkManager->GetStreamingOffsets(Near.StreamingRadius);
+	const int32 DeletedOffset = Offsets.IndexOfByKey(DeletedChunk - Near.StreamingCenter);
+	TestTrue(TEXT("Deleted chunk is inside the observer's volume"), DeletedOffset != INDEX_NONE);
+	TestTrue(TEXT("Observer containing the deleted chunk reaches it again"), Near.LoadCursor <= DeletedOffset);
+	TestEqual(TEXT("Observer not containing the deleted chunk keeps its place"), ChunkManager->StreamingObservers[1].LoadCursor, NumOffsets);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
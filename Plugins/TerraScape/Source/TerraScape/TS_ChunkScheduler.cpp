@@ -0,0 +1,157 @@
+/**
+ * @file TS_ChunkScheduler.cpp
+ * @brief Priority queue for chunk generation and meshing work
+ * @author Keves
+ * @version 1.0
+ */
+
+#include "TS_ChunkScheduler.h"
+
+void FTS_ChunkScheduler::SetChunkCallbacks(FChunkCenterFunc InGetChunkCenter, FChunkLODFunc InGetChunkLOD)
+{
+	GetChunkCenter = MoveTemp(InGetChunkCenter);
+	GetChunkLOD = MoveTemp(InGetChunkLOD);
+}
+
+void FTS_ChunkScheduler::SetView(const FTS_ChunkSchedulerView& NewView)
+{
+	View = NewView;
+	if (!View.IsValid() || Queued.Num() == 0)
+	{
+		return;
+	}
+
+	// Re-rank after anyone moves a quarter chunk or turns about 15 degrees; smaller changes barely reorder anything
+	bool bChanged = View.Observers.Num() != RankedView.Observers.Num();
+	const float RankDistance = FMath::Max(View.ChunkRadius * 0.25f, 1.0f);
+	for (int32 Index = 0; Index < View.Observers.Num() && !bChanged; Index++)
+	{
+		const FTS_ChunkSchedulerObserver& Observer = View.Observers[Index];
+		const FTS_ChunkSchedulerObserver& RankedObserver = RankedView.Observers[Index];
+		bChanged = FVector::DistSquared(Observer.Location, RankedObserver.Location) > RankDistance * RankDistance
+			|| FVector::DotProduct(Observer.Forward, RankedObserver.Forward) < 0.966f
+			|| Observer.PriorityWeight != RankedObserver.PriorityWeight;
+	}
+
+	if (bChanged)
+	{
+		Reprioritize();
+	}
+}
+
+bool FTS_ChunkScheduler::Enqueue(const FIntVector& ChunkID)
+{
+	if (Queued.Contains(ChunkID))
+	{
+		return false; // Coalesce with the pending request
+	}
+
+	const uint32 Sequence = NextSequence++;
+	Queued.Add(ChunkID, Sequence);
+	Heap.HeapPush(FEntry{ ChunkID, CalculatePriority(ChunkID), Sequence }, FEntryPredicate());
+	return true;
+}
+
+bool FTS_ChunkScheduler::Remove(const FIntVector& ChunkID)
+{
+	if (Queued.Remove(ChunkID) == 0)
+	{
+		return false;
+	}
+
+	// The heap entry goes stale and is skipped on pop; rebuild once stale entries dominate
+	if (Heap.Num() > Queued.Num() * 2 + 64)
+	{
+		Reprioritize();
+	}
+	return true;
+}
+
+bool FTS_ChunkScheduler::PopNext(FIntVector& OutChunkID, TFunctionRef<bool(const FIntVector&)> CanStart)
+{
+	TArray<FEntry, TInlineAllocator<16>> Refused;
+	bool bFound = false;
+
+	while (Heap.Num() > 0)
+	{
+		FEntry Entry;
+		Heap.HeapPop(Entry, FEntryPredicate(), EAllowShrinking::No);
+
+		if (!IsLive(Entry))
+		{
+			continue; // Removed or re-queued since
+		}
+
+		if (!CanStart(Entry.ChunkID))
+		{
+			Refused.Add(Entry);
+			continue;
+		}
+
+		Queued.Remove(Entry.ChunkID);
+		OutChunkID = Entry.ChunkID;
+		bFound = true;
+		break;
+	}
+
+	// Refused chunks keep their place
+	for (const FEntry& Entry : Refused)
+	{
+		Heap.HeapPush(Entry, FEntryPredicate());
+	}
+
+	return bFound;
+}
+
+void FTS_ChunkScheduler::Reprioritize()
+{
+	Heap.Reset(Queued.Num());
+	for (const TPair<FIntVector, uint32>& QueuedPair : Queued)
+	{
+		Heap.Add(FEntry{ QueuedPair.Key, CalculatePriority(QueuedPair.Key), QueuedPair.Value });
+	}
+	Heap.Heapify(FEntryPredicate());
+
+	RankedView = View;
+}
+
+float FTS_ChunkScheduler::CalculatePriority(const FIntVector& ChunkID) const
+{
+	if (!View.IsValid() || !GetChunkCenter)
+	{
+		return 0.0f; // No observer yet: FIFO by sequence
+	}
+
+	// Ranked for the observer it matters most to, so a chunk shared by several is scheduled once at its best rank
+	const FVector ChunkCenter = GetChunkCenter(ChunkID);
+	float Priority = MAX_flt;
+	for (const FTS_ChunkSchedulerObserver& Observer : View.Observers)
+	{
+		const FVector ToChunk = ChunkCenter - Observer.Location;
+		const float Distance = ToChunk.Size();
+		float ObserverPriority = Distance;
+
+		// Chunks in front of the observer first; the ones around them always count as visible
+		const bool bInView = Distance <= View.ChunkRadius
+			|| FVector::DotProduct(ToChunk / Distance, Observer.Forward) >= View.CosHalfViewAngle;
+		if (!bInView)
+		{
+			ObserverPriority *= OutOfViewPriorityScale;
+		}
+
+		Priority = FMath::Min(Priority, ObserverPriority / FMath::Max(Observer.PriorityWeight, KINDA_SMALL_NUMBER));
+	}
+
+	if (GetChunkLOD)
+	{
+		Priority *= 1.0f + LODPriorityScale * GetChunkLOD(ChunkID);
+	}
+
+	return Priority;
+}
+
+void FTS_ChunkScheduler::Empty()
+{
+	Heap.Empty();
+	Queued.Empty();
+}
@@ -0,0 +1,142 @@
+/**
+ * @file TS_ChunkScheduler.h
+ * @brief Priority queue for chunk generation and meshing work
+ * @author Keves
+ * @version 1.0
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @brief One observer's eye position and view direction
+ */
+struct TERRA_SCAPE_API FTS_ChunkSchedulerObserver
+{
+	/** Observer position in world space */
+	FVector Location = FVector::ZeroVector;
+
+	/** Observer view direction (unit length) */
+	FVector Forward = FVector::ForwardVector;
+
+	/** Work near an observer with weight 2 ranks as if it were half as far away */
+	float PriorityWeight = 1.0f;
+};
+
+/**
+ * @brief Where the observers are and look, used to rank queued chunks
+ */
+struct TERRA_SCAPE_API FTS_ChunkSchedulerView
+{
+	/** Every observer; a chunk is ranked by the one it matters most to */
+	TArray<FTS_ChunkSchedulerObserver> Observers;
+
+	/** Cosine of half the view cone angle; chunks whose centre lies inside the cone count as visible */
+	float CosHalfViewAngle = 0.5f;
+
+	/** Distance from a chunk centre to its corners; chunks this close always count as visible */
+	float ChunkRadius = 0.0f;
+
+	/** False until an observer is known, in which case the queue is plain FIFO */
+	FORCEINLINE bool IsValid() const { return Observers.Num() > 0; }
+};
+
+/**
+ * @brief Binary heap of chunk IDs ordered by distance to the nearest observer, view cone and LOD
+ * Each chunk is queued at most once: enqueueing a queued chunk is a no-op and removing one is O(1)
+ * (its heap entry is dropped lazily when it reaches the top). Priorities are only recomputed
+ * when an observer has moved or turned far enough to change the order noticeably.
+ */
+class TERRA_SCAPE_API FTS_ChunkScheduler
+{
+public:
+	/** World-space centre of a chunk */
+	using FChunkCenterFunc = TFunction<FVector(const FIntVector&)>;
+
+	/** LOD a chunk will be meshed at */
+	using FChunkLODFunc = TFunction<int32(const FIntVector&)>;
+
+	/** Priority multiplier for chunks outside the view cone */
+	float OutOfViewPriorityScale = 3.0f;
+
+	/** Priority multiplier added per LOD level, so coarse chunks yield to fine ones at similar distance */
+	float LODPriorityScale = 0.25f;
+
+	/** Set the callbacks used to rank chunks */
+	void SetChunkCallbacks(FChunkCenterFunc InGetChunkCenter, FChunkLODFunc InGetChunkLOD);
+
+	/** Update the observers; re-ranks the whole queue only if one moved or turned enough since the last ranking */
+	void SetView(const FTS_ChunkSchedulerView& NewView);
+
+	/**
+	 * Queue a chunk, or do nothing if it's already queued
+	 * @return True if the chunk was added
+	 */
+	bool Enqueue(const FIntVector& ChunkID);
+
+	/**
+	 * Drop a queued chunk (e.g. because it was deleted)
+	 * @return True if the chunk was queued
+	 */
+	bool Remove(const FIntVector& ChunkID);
+
+	/**
+	 * Take the most urgent chunk that CanStart accepts; chunks it refuses stay queued in place
+	 * @return False if no queued chunk was accepted
+	 */
+	bool PopNext(FIntVector& OutChunkID, TFunctionRef<bool(const FIntVector&)> CanStart);
+
+	/** Recompute every priority and rebuild the heap */
+	void Reprioritize();
+
+	/** Priority of a chunk for the current view (lower runs sooner) */
+	float CalculatePriority(const FIntVector& ChunkID) const;
+
+	FORCEINLINE bool Contains(const FIntVector& ChunkID) const { return Queued.Contains(ChunkID); }
+	FORCEINLINE int32 Num() const { return Queued.Num(); }
+	FORCEINLINE bool IsEmpty() const { return Queued.Num() == 0; }
+
+	void Empty();
+
+private:
+	struct FEntry
+	{
+		FIntVector ChunkID;
+		float Priority;
+
+		/** Enqueue order, breaks ties so equal priorities stay FIFO */
+		uint32 Sequence;
+	};
+
+	/** Heap order predicate: true when A should run before B */
+	struct FEntryPredicate
+	{
+		FORCEINLINE bool operator()(const FEntry& A, const FEntry& B) const
+		{
+			return A.Priority < B.Priority || (A.Priority == B.Priority && A.Sequence < B.Sequence);
+		}
+	};
+
+	/** Heap entries; may hold entries for chunks that were removed since */
+	TArray<FEntry> Heap;
+
+	/** Queued chunks and the sequence of their live heap entry */
+	TMap<FIntVector, uint32> Queued;
+
+	uint32 NextSequence = 0;
+
+	FChunkCenterFunc GetChunkCenter;
+	FChunkLODFunc GetChunkLOD;
+
+	/** Current observers and the ones the heap was last ranked for */
+	FTS_ChunkSchedulerView View;
+	FTS_ChunkSchedulerView RankedView;
+
+	/** Whether a heap entry still represents a queued chunk */
+	FORCEINLINE bool IsLive(const FEntry& Entry) const
+	{
+		const uint32* Sequence = Queued.Find(Entry.ChunkID);
+		return Sequence && *Sequence == Entry.Sequence;
+	}
+};
@@ -0,0 +1,399 @@
+/**
+ * @file TS_ChunkStorage.cpp
+ * @brief Paletted, bit-packed voxel storage for TerraScape chunks
+ * @author Keves
+ * @version 1.0
+ */
+
+#include "TS_ChunkStorage.h"
+#include "TS_Stats.h"
+
+/** Largest palette a 16-bit index can address */
+static constexpr int32 MaxPaletteSize = 1 << 16;
+
+FTS_ChunkVoxelStorage::FTS_ChunkVoxelStorage(int32 InChunkSize, int32 FillMaterialID)
+{
+	Init(InChunkSize, FillMaterialID);
+}
+
+void FTS_ChunkVoxelStorage::Init(int32 InChunkSize, int32 FillMaterialID)
+{
+	ChunkSize = FMath::Max(0, InChunkSize);
+	BitsPerIndex = 1;
+	Mips.Reset();
+	Palette.Reset();
+	Palette.Add(FillMaterialID);
+
+	// Every index is 0, which is FillMaterialID
+	AllocateWords();
+}
+
+void FTS_ChunkVoxelStorage::SetFromVoxels(int32 InChunkSize, TArrayView<const FTS_Voxel> Voxels)
+{
+	ChunkSize = FMath::Max(0, InChunkSize);
+	Mips.Reset();
+	Palette.Reset();
+
+	if (Voxels.Num() != Num())
+	{
+		UE_LOG(LogTerraScape, Error, TEXT("Chunk storage size mismatch: expected %d voxels, got %d"), Num(), Voxels.Num());
+		Init(InChunkSize);
+		return;
+	}
+
+	// First pass: palette, remembering the last hit since neighbouring voxels mostly share a material
+	TArray<uint16> PaletteIndices;
+	PaletteIndices.SetNumUninitialized(Voxels.Num());
+	int32 LastMaterialID = INDEX_NONE;
+	uint16 LastPaletteIndex = 0;
+	for (int32 Index = 0; Index < Voxels.Num(); Index++)
+	{
+		const int32 MaterialID = Voxels[Index].MaterialID;
+		if (MaterialID != LastMaterialID || Palette.Num() == 0)
+		{
+			int32 PaletteIndex = Palette.Find(MaterialID);
+			if (PaletteIndex == INDEX_NONE)
+			{
+				if (Palette.Num() >= MaxPaletteSize)
+				{
+					UE_LOG(LogTerraScape, Error, TEXT("Chunk has more than %d materials, storing material %d as air"), MaxPaletteSize, MaterialID);
+					PaletteIndex = Palette.Find(0);
+					PaletteIndex = PaletteIndex != INDEX_NONE ? PaletteIndex : 0;
+				}
+				else
+				{
+					PaletteIndex = Palette.Add(MaterialID);
+				}
+			}
+			LastMaterialID = MaterialID;
+			LastPaletteIndex = static_cast<uint16>(PaletteIndex);
+		}
+		PaletteIndices[Index] = LastPaletteIndex;
+	}
+
+	if (Palette.Num() == 0)
+	{
+		Palette.Add(0); // Zero-sized chunk
+	}
+
+	// Second pass: pack at the final width
+	BitsPerIndex = GetBitsForPaletteSize(Palette.Num());
+	AllocateWords();
+	for (int32 Index = 0; Index < PaletteIndices.Num(); Index++)
+	{
+		SetPaletteIndex(Index, PaletteIndices[Index]);
+	}
+}
+
+void FTS_ChunkVoxelStorage::Compact()
+{
+	if (!IsValid())
+	{
+		return;
+	}
+
+	// Find which palette entries are still referenced
+	TArray<bool> bUsed;
+	bUsed.Init(false, Palette.Num());
+	const int32 TotalVoxels = Num();
+	for (int32 Index = 0; Index < TotalVoxels; Index++)
+	{
+		bUsed[GetPaletteIndex(Index)] = true;
+	}
+
+	TArray<int32> Remap;
+	Remap.SetNumUninitialized(Palette.Num());
+	TArray<int32> NewPalette;
+	for (int32 PaletteIndex = 0; PaletteIndex < Palette.Num(); PaletteIndex++)
+	{
+		Remap[PaletteIndex] = bUsed[PaletteIndex] ? NewPalette.Add(Palette[PaletteIndex]) : INDEX_NONE;
+	}
+
+	if (NewPalette.Num() == Palette.Num())
+	{
+		return; // Nothing to drop
+	}
+
+	// Re-encode with the remapped indices at the (possibly smaller) new width
+	TArray<uint16> PaletteIndices;
+	PaletteIndices.SetNumUninitialized(TotalVoxels);
+	for (int32 Index = 0; Index < TotalVoxels; Index++)
+	{
+		PaletteIndices[Index] = static_cast<uint16>(Remap[GetPaletteIndex(Index)]);
+	}
+
+	Palette = MoveTemp(NewPalette);
+	BitsPerIndex = GetBitsForPaletteSize(Palette.Num());
+	AllocateWords();
+	for (int32 Index = 0; Index < TotalVoxels; Index++)
+	{
+		SetPaletteIndex(Index, PaletteIndices[Index]);
+	}
+}
+
+void FTS_ChunkVoxelStorage::Set(int32 Index, int32 MaterialID)
+{
+	if (Index < 0 || Index >= Num())
+	{
+		return;
+	}
+
+	const int32 PaletteIndex = FindOrAddPaletteIndex(MaterialID);
+	if (PaletteIndex != INDEX_NONE)
+	{
+		SetPaletteIndex(Index, static_cast<uint32>(PaletteIndex));
+	}
+}
+
+void FTS_ChunkVoxelStorage::Set(int32 X, int32 Y, int32 Z, int32 MaterialID)
+{
+	if (X < 0 || X >= ChunkSize || Y < 0 || Y >= ChunkSize || Z < 0 || Z >= ChunkSize)
+	{
+		return;
+	}
+
+	Set(GetIndex(X, Y, Z), MaterialID);
+	UpdateMips(X, Y, Z);
+}
+
+void FTS_ChunkVoxelStorage::BuildMips(int32 NumLevels, bool bAnySolid)
+{
+	Mips.Reset();
+	bAnySolidMips = bAnySolid;
+
+	TArray<FTS_Voxel> CoarseVoxels;
+	for (int32 Level = 1; Level <= NumLevels; Level++)
+	{
+		const FTS_ChunkVoxelStorage& Fine = (Level == 1) ? *this : Mips.Last();
+		const int32 CoarseSize = Fine.ChunkSize / 2;
+		if (CoarseSize < 1)
+		{
+			break;
+		}
+
+		CoarseVoxels.Reset(CoarseSize * CoarseSize * CoarseSize);
+		for (int32 Z = 0; Z < CoarseSize; Z++)
+		{
+			for (int32 Y = 0; Y < CoarseSize; Y++)
+			{
+				for (int32 X = 0; X < CoarseSize; X++)
+				{
+					CoarseVoxels.Add(FTS_Voxel(ReduceBlock(Fine, X, Y, Z, bAnySolid)));
+				}
+			}
+		}
+
+		FTS_ChunkVoxelStorage& Coarse = Mips.AddDefaulted_GetRef();
+		Coarse.SetFromVoxels(CoarseSize, CoarseVoxels);
+	}
+}
+
+int32 FTS_ChunkVoxelStorage::ReduceMaterials(const int32* Materials, int32 NumMaterials, bool bAnySolid)
+{
+	int32 BestMaterialID = 0;
+	int32 BestCount = 0;
+	int32 SolidCount = 0;
+	for (int32 i = 0; i < NumMaterials; i++)
+	{
+		if (Materials[i] <= 0)
+		{
+			continue;
+		}
+		SolidCount++;
+
+		// Count each material once, at its first occurrence
+		bool bCounted = false;
+		for (int32 j = 0; j < i && !bCounted; j++)
+		{
+			bCounted = Materials[j] == Materials[i];
+		}
+		if (bCounted)
+		{
+			continue;
+		}
+
+		int32 Count = 0;
+		for (int32 j = i; j < NumMaterials; j++)
+		{
+			Count += Materials[j] == Materials[i] ? 1 : 0;
+		}
+		if (Count > BestCount)
+		{
+			BestCount = Count;
+			BestMaterialID = Materials[i];
+		}
+	}
+
+	// Majority keeps half-filled blocks solid so coarse surfaces don't sink below the real ones
+	const bool bSolid = bAnySolid ? SolidCount > 0 : SolidCount * 2 >= NumMaterials;
+	return bSolid ? BestMaterialID : 0;
+}
+
+int32 FTS_ChunkVoxelStorage::ReduceBlock(const FTS_ChunkVoxelStorage& Fine, int32 X, int32 Y, int32 Z, bool bAnySolid)
+{
+	int32 Materials[8];
+	int32 NumMaterials = 0;
+	for (int32 DZ = 0; DZ < 2; DZ++)
+	{
+		for (int32 DY = 0; DY < 2; DY++)
+		{
+			for (int32 DX = 0; DX < 2; DX++)
+			{
+				Materials[NumMaterials++] = Fine.Get(X * 2 + DX, Y * 2 + DY, Z * 2 + DZ);
+			}
+		}
+	}
+	return ReduceMaterials(Materials, NumMaterials, bAnySolid);
+}
+
+void FTS_ChunkVoxelStorage::UpdateMips(int32 X, int32 Y, int32 Z)
+{
+	for (int32 Level = 1; Level <= Mips.Num(); Level++)
+	{
+		const FTS_ChunkVoxelStorage& Fine = (Level == 1) ? *this : Mips[Level - 2];
+		FTS_ChunkVoxelStorage& Coarse = Mips[Level - 1];
+
+		const int32 CoarseX = X >> Level;
+		const int32 CoarseY = Y >> Level;
+		const int32 CoarseZ = Z >> Level;
+		if (CoarseX >= Coarse.ChunkSize || CoarseY >= Coarse.ChunkSize || CoarseZ >= Coarse.ChunkSize)
+		{
+			return; // Odd chunk sizes drop the last fine voxel
+		}
+
+		const int32 MaterialID = ReduceBlock(Fine, CoarseX, CoarseY, CoarseZ, bAnySolidMips);
+		if (Coarse.Get(CoarseX, CoarseY, CoarseZ) == MaterialID)
+		{
+			return; // Coarser levels can't change either
+		}
+		Coarse.Set(Coarse.GetIndex(CoarseX, CoarseY, CoarseZ), MaterialID);
+	}
+}
+
+void FTS_ChunkVoxelStorage::Decode(TArrayView<int32> OutMaterials) const
+{
+	if (OutMaterials.Num() < Num())
+	{
+		UE_LOG(LogTerraScape, Error, TEXT("Chunk storage decode target too small: %d < %d"), OutMaterials.Num(), Num());
+		return;
+	}
+
+	ForEachVoxel([&OutMaterials](int32 Index, int32 MaterialID)
+	{
+		OutMaterials[Index] = MaterialID;
+	});
+}
+
+int32 FTS_ChunkVoxelStorage::CountSolidVoxels() const
+{
+	int32 SolidCount = 0;
+	ForEachVoxel([&SolidCount](int32 Index, int32 MaterialID)
+	{
+		SolidCount += MaterialID > 0 ? 1 : 0;
+	});
+	return SolidCount;
+}
+
+SIZE_T FTS_ChunkVoxelStorage::GetAllocatedSize() const
+{
+	SIZE_T AllocatedSize = Palette.GetAllocatedSize() + Words.GetAllocatedSize() + Mips.GetAllocatedSize();
+	for (const FTS_ChunkVoxelStorage& Mip : Mips)
+	{
+		AllocatedSize += Mip.GetAllocatedSize();
+	}
+	return AllocatedSize;
+}
+
+void FTS_ChunkVoxelStorage::Serialize(FArchive& Ar)
+{
+	Ar << ChunkSize;
+	Ar << BitsPerIndex;
+	Ar << Palette;
+	Ar << Words;
+
+	if (Ar.IsLoading())
+	{
+		// Mips are derived data, the owner rebuilds them with its own LOD settings
+		Mips.Reset();
+		bAnySolidMips = false;
+
+		// Reject anything the accessors can't index safely
+		const bool bValidWidth = BitsPerIndex == 1 || BitsPerIndex == 2 || BitsPerIndex == 4 || BitsPerIndex == 8 || BitsPerIndex == 16;
+		const int32 IndicesPerWord = bValidWidth ? 64 / BitsPerIndex : 1;
+		if (Ar.IsError() || !bValidWidth || ChunkSize <= 0 || Palette.Num() == 0 || Palette.Num() > (1 << BitsPerIndex)
+			|| Words.Num() != (Num() + IndicesPerWord - 1) / IndicesPerWord)
+		{
+			Ar.SetError();
+			*this = FTS_ChunkVoxelStorage();
+		}
+	}
+}
+
+int32 FTS_ChunkVoxelStorage::GetBitsForPaletteSize(int32 PaletteSize)
+{
+	if (PaletteSize <= 2)
+	{
+		return 1;
+	}
+	if (PaletteSize <= 4)
+	{
+		return 2;
+	}
+	if (PaletteSize <= 16)
+	{
+		return 4;
+	}
+	if (PaletteSize <= 256)
+	{
+		return 8;
+	}
+	return 16;
+}
+
+void FTS_ChunkVoxelStorage::AllocateWords()
+{
+	const int32 IndicesPerWord = 64 / BitsPerIndex;
+	Words.Reset();
+	Words.SetNumZeroed((Num() + IndicesPerWord - 1) / IndicesPerWord);
+}
+
+void FTS_ChunkVoxelStorage::Repack(int32 NewBitsPerIndex)
+{
+	const int32 TotalVoxels = Num();
+	TArray<uint16> PaletteIndices;
+	PaletteIndices.SetNumUninitialized(TotalVoxels);
+	for (int32 Index = 0; Index < TotalVoxels; Index++)
+	{
+		PaletteIndices[Index] = static_cast<uint16>(GetPaletteIndex(Index));
+	}
+
+	BitsPerIndex = NewBitsPerIndex;
+	AllocateWords();
+	for (int32 Index = 0; Index < TotalVoxels; Index++)
+	{
+		SetPaletteIndex(Index, PaletteIndices[Index]);
+	}
+}
+
+int32 FTS_ChunkVoxelStorage::FindOrAddPaletteIndex(int32 MaterialID)
+{
+	const int32 ExistingIndex = Palette.Find(MaterialID);
+	if (ExistingIndex != INDEX_NONE)
+	{
+		return ExistingIndex;
+	}
+
+	if (Palette.Num() >= MaxPaletteSize)
+	{
+		UE_LOG(LogTerraScape, Error, TEXT("Chunk palette is full (%d materials), cannot add material %d"), MaxPaletteSize, MaterialID);
+		return INDEX_NONE;
+	}
+
+	const int32 NewIndex = Palette.Add(MaterialID);
+	const int32 NewBitsPerIndex = GetBitsForPaletteSize(Palette.Num());
+	if (NewBitsPerIndex != BitsPerIndex)
+	{
+		Repack(NewBitsPerIndex);
+	}
+	return NewIndex;
+}
@@ -0,0 +1,194 @@
+/**
+ * @file TS_ChunkStorage.h
+ * @brief Paletted, bit-packed voxel storage for TerraScape chunks
+ * @author Keves
+ * @version 1.0
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TS_VoxelTypes.h"
+
+/**
+ * @brief Voxel materials of one chunk as a palette plus bit-packed palette indices
+ * Indices use 1, 2, 4, 8 or 16 bits depending on the palette size, so they never straddle
+ * a 64-bit word. Voxels are indexed X + Y * ChunkSize + Z * ChunkSize * ChunkSize, like the
+ * flat arrays the world generator produces.
+ *
+ * Optionally holds a mip pyramid for LOD meshing: level N has ChunkSize >> N voxels per axis, each
+ * reduced from 2x2x2 voxels of the level below, and Set keeps it up to date.
+ */
+class TERRA_SCAPE_API FTS_ChunkVoxelStorage
+{
+public:
+	FTS_ChunkVoxelStorage() = default;
+
+	/** Create storage for a ChunkSize^3 chunk filled with one material */
+	explicit FTS_ChunkVoxelStorage(int32 InChunkSize, int32 FillMaterialID = 0);
+
+	/** Reset to a ChunkSize^3 chunk filled with one material */
+	void Init(int32 InChunkSize, int32 FillMaterialID = 0);
+
+	/** Build the palette and pack a flat voxel array in one go (packs at the final width, no repacking) */
+	void SetFromVoxels(int32 InChunkSize, TArrayView<const FTS_Voxel> Voxels);
+
+	/** Drop palette entries no voxel uses any more and shrink the index width if possible */
+	void Compact();
+
+	/**
+	 * Build mip levels 1..NumLevels from this storage (stops early once a level would be empty)
+	 * @param bAnySolid - A coarse voxel is solid if any of its 8 children is, instead of at least half
+	 */
+	void BuildMips(int32 NumLevels, bool bAnySolid);
+
+	/** Number of mip levels below full resolution */
+	FORCEINLINE int32 GetNumMips() const { return Mips.Num(); }
+
+	/** Whether the mips use the "any solid" reduction rather than majority */
+	FORCEINLINE bool UsesAnySolidMips() const { return bAnySolidMips; }
+
+	/** Storage at a mip level, 0 being this storage; nullptr if that level wasn't built */
+	const FTS_ChunkVoxelStorage* GetMip(int32 Level) const
+	{
+		if (Level == 0)
+		{
+			return this;
+		}
+		return Mips.IsValidIndex(Level - 1) ? &Mips[Level - 1] : nullptr;
+	}
+
+	/**
+	 * Reduce a block of child materials to one coarse material: air unless enough children are solid,
+	 * otherwise the most common solid material
+	 */
+	static int32 ReduceMaterials(const int32* Materials, int32 NumMaterials, bool bAnySolid);
+
+	FORCEINLINE bool IsValid() const { return ChunkSize > 0; }
+	FORCEINLINE int32 GetChunkSize() const { return ChunkSize; }
+	FORCEINLINE int32 Num() const { return ChunkSize * ChunkSize * ChunkSize; }
+	FORCEINLINE int32 GetBitsPerIndex() const { return BitsPerIndex; }
+	FORCEINLINE const TArray<int32>& GetPalette() const { return Palette; }
+
+	/** True when the palette has a single material (call Compact first after edits to be exact) */
+	FORCEINLINE bool IsUniform() const { return Palette.Num() == 1; }
+
+	FORCEINLINE int32 GetIndex(int32 X, int32 Y, int32 Z) const
+	{
+		return X + Y * ChunkSize + Z * ChunkSize * ChunkSize;
+	}
+
+	/** Material of a voxel by flat index */
+	FORCEINLINE int32 Get(int32 Index) const
+	{
+		return Palette[GetPaletteIndex(Index)];
+	}
+
+	/** Material of a voxel by local coordinates */
+	FORCEINLINE int32 Get(int32 X, int32 Y, int32 Z) const
+	{
+		return Get(GetIndex(X, Y, Z));
+	}
+
+	/** Change a voxel's material, growing the palette and index width when needed (mips are not updated) */
+	void Set(int32 Index, int32 MaterialID);
+
+	/** Change a voxel's material and update the mips covering it */
+	void Set(int32 X, int32 Y, int32 Z, int32 MaterialID);
+
+	/**
+	 * Visit every voxel in index order, decoding a whole word at a time
+	 * @param Func - Called as Func(int32 Index, int32 MaterialID)
+	 */
+	template<typename FuncType>
+	void ForEachVoxel(FuncType&& Func) const
+	{
+		const int32 IndicesPerWord = 64 / BitsPerIndex;
+		const uint64 Mask = (uint64(1) << BitsPerIndex) - 1;
+		const int32 TotalVoxels = Num();
+
+		for (int32 WordIndex = 0; WordIndex < Words.Num(); WordIndex++)
+		{
+			uint64 Word = Words[WordIndex];
+			const int32 FirstIndex = WordIndex * IndicesPerWord;
+			const int32 LastIndex = FMath::Min(FirstIndex + IndicesPerWord, TotalVoxels);
+			for (int32 Index = FirstIndex; Index < LastIndex; Index++)
+			{
+				Func(Index, Palette[Word & Mask]);
+				Word >>= BitsPerIndex;
+			}
+		}
+	}
+
+	/** Unpack every voxel's material into a flat array of Num() entries */
+	void Decode(TArrayView<int32> OutMaterials) const;
+
+	/** Number of voxels with a solid material */
+	int32 CountSolidVoxels() const;
+
+	/** Heap memory used by the palette, packed indices and mips */
+	SIZE_T GetAllocatedSize() const;
+
+	/** Read or write the palette and packed indices; mips are not included and must be rebuilt after loading */
+	void Serialize(FArchive& Ar);
+
+private:
+	int32 ChunkSize = 0;
+	int32 BitsPerIndex = 1;
+
+	/** Materials referenced by the packed indices */
+	TArray<int32> Palette;
+
+	/** Palette indices, 64 / BitsPerIndex per word, lowest bits first */
+	TArray<uint64> Words;
+
+	/** Mip levels 1..N (Mips[0] is half resolution), empty unless BuildMips was called */
+	TArray<FTS_ChunkVoxelStorage> Mips;
+	bool bAnySolidMips = false;
+
+	/** Reduce the 2x2x2 block of Fine under a coarse voxel */
+	static int32 ReduceBlock(const FTS_ChunkVoxelStorage& Fine, int32 X, int32 Y, int32 Z, bool bAnySolid);
+
+	/** Recompute the mip voxels covering a changed full-resolution voxel */
+	void UpdateMips(int32 X, int32 Y, int32 Z);
+
+	/** Smallest supported index width for a palette of this size */
+	static int32 GetBitsForPaletteSize(int32 PaletteSize);
+
+	/** Allocate zeroed words for Num() indices at the current width */
+	void AllocateWords();
+
+	/** Re-encode every index at a new width */
+	void Repack(int32 NewBitsPerIndex);
+
+	/** Find a material in the palette, adding it (and widening indices) if missing; INDEX_NONE when full */
+	int32 FindOrAddPaletteIndex(int32 MaterialID);
+
+	FORCEINLINE uint32 GetPaletteIndex(int32 Index) const
+	{
+		const int32 BitIndex = Index * BitsPerIndex;
+		const uint64 Mask = (uint64(1) << BitsPerIndex) - 1;
+		return static_cast<uint32>((Words[BitIndex >> 6] >> (BitIndex & 63)) & Mask);
+	}
+
+	FORCEINLINE void SetPaletteIndex(int32 Index, uint32 PaletteIndex)
+	{
+		const int32 BitIndex = Index * BitsPerIndex;
+		const uint64 Mask = (uint64(1) << BitsPerIndex) - 1;
+		uint64& Word = Words[BitIndex >> 6];
+		Word = (Word & ~(Mask << (BitIndex & 63))) | (uint64(PaletteIndex) << (BitIndex & 63));
+	}
+};
+
+/**
+ * Shared handle to a chunk's voxel storage
+ * The chunk manager holds the only mutable reference; mesh tasks receive a const view of the same
+ * buffer, and an edit copies the storage first if a task still holds it.
+ */
+using FTS_ChunkVoxelStorageRef = TSharedRef<FTS_ChunkVoxelStorage, ESPMode::ThreadSafe>;
+
+/** Nullable FTS_ChunkVoxelStorageRef, for chunks that may not have voxel storage */
+using FTS_ChunkVoxelStoragePtr = TSharedPtr<FTS_ChunkVoxelStorage, ESPMode::ThreadSafe>;
+
+/** Read-only view of a chunk's voxel storage, handed to worker tasks without copying */
+using FTS_ChunkVoxelSnapshot = TSharedRef<const FTS_ChunkVoxelStorage, ESPMode::ThreadSafe>;
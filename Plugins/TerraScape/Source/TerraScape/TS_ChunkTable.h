@@ -0,0 +1,217 @@
+/**
+ * @file TS_ChunkTable.h
+ * @brief Dense chunk record storage with an open-addressed chunk ID index
+ * @author Keves
+ * @version 1.0
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/SparseArray.h"
+#include "TS_VoxelTypes.h"
+
+/**
+ * @brief Chunk records in a slot array, found through an open-addressed hash of their chunk IDs
+ * Record indices stay valid until the record is removed, so they can be held instead of chunk IDs;
+ * each record also keeps the indices of its six face neighbours (in FTS_ChunkFaces order), which
+ * makes neighbour access a single indexed read. Iteration walks the slot array in memory order.
+ *
+ * RecordType needs a FIntVector ChunkID and an int32 Neighbors[6]; Add sets both.
+ */
+template<typename RecordType>
+class TTS_ChunkTable
+{
+public:
+	/** Index of a chunk's record, INDEX_NONE if it has none */
+	int32 FindIndex(const FIntVector& ChunkID) const
+	{
+		if (Slots.Num() == 0)
+		{
+			return INDEX_NONE;
+		}
+
+		const uint32 Mask = Slots.Num() - 1;
+		for (uint32 Slot = HashChunkID(ChunkID) & Mask; ; Slot = (Slot + 1) & Mask)
+		{
+			const int32 Index = Slots[Slot];
+			if (Index == INDEX_NONE || Records[Index].ChunkID == ChunkID)
+			{
+				return Index;
+			}
+		}
+	}
+
+	FORCEINLINE RecordType* Find(const FIntVector& ChunkID)
+	{
+		const int32 Index = FindIndex(ChunkID);
+		return Index != INDEX_NONE ? &Records[Index] : nullptr;
+	}
+
+	FORCEINLINE const RecordType* Find(const FIntVector& ChunkID) const
+	{
+		const int32 Index = FindIndex(ChunkID);
+		return Index != INDEX_NONE ? &Records[Index] : nullptr;
+	}
+
+	FORCEINLINE bool Contains(const FIntVector& ChunkID) const { return FindIndex(ChunkID) != INDEX_NONE; }
+
+	FORCEINLINE RecordType& operator[](int32 Index) { return Records[Index]; }
+	FORCEINLINE const RecordType& operator[](int32 Index) const { return Records[Index]; }
+
+	/** Record of the neighbour across a face, nullptr if it isn't loaded */
+	FORCEINLINE RecordType* GetNeighbor(const RecordType& Record, int32 FaceIndex)
+	{
+		const int32 Index = Record.Neighbors[FaceIndex];
+		return Index != INDEX_NONE ? &Records[Index] : nullptr;
+	}
+
+	FORCEINLINE const RecordType* GetNeighbor(const RecordType& Record, int32 FaceIndex) const
+	{
+		const int32 Index = Record.Neighbors[FaceIndex];
+		return Index != INDEX_NONE ? &Records[Index] : nullptr;
+	}
+
+	/** Add a default record for a chunk that has none yet and link it with its neighbours, returns its index */
+	int32 Add(const FIntVector& ChunkID)
+	{
+		check(!Contains(ChunkID));
+
+		// Keep the load factor at or below one half so probe runs stay short
+		if ((Records.Num() + 1) * 2 > Slots.Num())
+		{
+			Rehash(FMath::Max(64, Slots.Num() * 2));
+		}
+
+		const int32 Index = Records.Add(RecordType());
+		RecordType& Record = Records[Index];
+		Record.ChunkID = ChunkID;
+
+		const uint32 Mask = Slots.Num() - 1;
+		uint32 Slot = HashChunkID(ChunkID) & Mask;
+		while (Slots[Slot] != INDEX_NONE)
+		{
+			Slot = (Slot + 1) & Mask;
+		}
+		Slots[Slot] = Index;
+
+		for (int32 FaceIndex = 0; FaceIndex < 6; FaceIndex++)
+		{
+			const int32 NeighborIndex = FindIndex(ChunkID + FTS_ChunkFaces::GetDirection(FaceIndex));
+			Record.Neighbors[FaceIndex] = NeighborIndex;
+			if (NeighborIndex != INDEX_NONE)
+			{
+				Records[NeighborIndex].Neighbors[FaceIndex ^ 1] = Index;
+			}
+		}
+
+		return Index;
+	}
+
+	/** Remove a chunk's record and unlink it from its neighbours */
+	bool Remove(const FIntVector& ChunkID)
+	{
+		if (Slots.Num() == 0)
+		{
+			return false;
+		}
+
+		const uint32 Mask = Slots.Num() - 1;
+		uint32 Slot = HashChunkID(ChunkID) & Mask;
+		while (Slots[Slot] != INDEX_NONE && Records[Slots[Slot]].ChunkID != ChunkID)
+		{
+			Slot = (Slot + 1) & Mask;
+		}
+
+		const int32 Index = Slots[Slot];
+		if (Index == INDEX_NONE)
+		{
+			return false;
+		}
+
+		// Backward-shift deletion: pull later entries of the probe run into the hole, no tombstones
+		uint32 Hole = Slot;
+		for (uint32 Next = (Hole + 1) & Mask; Slots[Next] != INDEX_NONE; Next = (Next + 1) & Mask)
+		{
+			const uint32 Home = HashChunkID(Records[Slots[Next]].ChunkID) & Mask;
+			if (((Next - Home) & Mask) >= ((Next - Hole) & Mask))
+			{
+				Slots[Hole] = Slots[Next];
+				Hole = Next;
+			}
+		}
+		Slots[Hole] = INDEX_NONE;
+
+		const RecordType& Record = Records[Index];
+		for (int32 FaceIndex = 0; FaceIndex < 6; FaceIndex++)
+		{
+			if (Record.Neighbors[FaceIndex] != INDEX_NONE)
+			{
+				Records[Record.Neighbors[FaceIndex]].Neighbors[FaceIndex ^ 1] = INDEX_NONE;
+			}
+		}
+
+		Records.RemoveAt(Index);
+		return true;
+	}
+
+	FORCEINLINE int32 Num() const { return Records.Num(); }
+
+	void Empty()
+	{
+		Records.Empty();
+		Slots.Empty();
+	}
+
+	/** Chunk IDs of every record */
+	void GetKeys(TArray<FIntVector>& OutChunkIDs) const
+	{
+		OutChunkIDs.Reset(Records.Num());
+		for (const RecordType& Record : Records)
+		{
+			OutChunkIDs.Add(Record.ChunkID);
+		}
+	}
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return Records.GetAllocatedSize() + Slots.GetAllocatedSize();
+	}
+
+	// Ranged-for over the records in slot order
+	FORCEINLINE auto begin() { return Records.begin(); }
+	FORCEINLINE auto end() { return Records.end(); }
+	FORCEINLINE auto begin() const { return Records.begin(); }
+	FORCEINLINE auto end() const { return Records.end(); }
+
+private:
+	/** Records, with holes reused by later adds */
+	TSparseArray<RecordType> Records;
+
+	/** Record index per hash slot, INDEX_NONE when empty; the size is a power of two */
+	TArray<int32> Slots;
+
+	/** Spread neighbouring chunk IDs over the whole table */
+	static FORCEINLINE uint32 HashChunkID(const FIntVector& ChunkID)
+	{
+		const uint32 Hash = static_cast<uint32>(ChunkID.X) * 0x8DA6B343u
+			^ static_cast<uint32>(ChunkID.Y) * 0xD8163841u
+			^ static_cast<uint32>(ChunkID.Z) * 0xCB1AB31Fu;
+		return Hash ^ (Hash >> 15);
+	}
+
+	void Rehash(int32 NewNumSlots)
+	{
+		Slots.Init(INDEX_NONE, NewNumSlots);
+		const uint32 Mask = NewNumSlots - 1;
+		for (typename TSparseArray<RecordType>::TConstIterator It(Records); It; ++It)
+		{
+			uint32 Slot = HashChunkID(It->ChunkID) & Mask;
+			while (Slots[Slot] != INDEX_NONE)
+			{
+				Slot = (Slot + 1) & Mask;
+			}
+			Slots[Slot] = It.GetIndex();
+		}
+	}
+};
@@ -6,6 +6,7 @@
  */
 
 #include "TS_MaterialData.h"
+#include "TS_Stats.h"
 #include "Engine/DataTable.h"
 #include "Materials/MaterialInterface.h"
 
@@ -28,12 +29,12 @@ void UTS_MaterialManager::InitializeMaterialDataTable(UDataTable* InMaterialData
 	
 	if (MaterialDataTable)
 	{
-		UE_LOG(LogTemp, Log, TEXT("TerraScape Material Manager: Initialized with data table containing %d rows"), 
+		UE_LOG(LogTerraScape, Log, TEXT("TerraScape Material Manager: Initialized with data table containing %d rows"), 
 			MaterialDataTable->GetRowMap().Num());
 	}
 	else
 	{
-		UE_LOG(LogTemp, Warning, TEXT("TerraScape Material Manager: No data table provided, using defaults only"));
+		UE_LOG(LogTerraScape, Warning, TEXT("TerraScape Material Manager: No data table provided, using defaults only"));
 	}
 }
 
@@ -1,18 +1,148 @@
 #include "TS_ProceduralNoise.h"
 #include "Math/UnrealMathUtility.h"
 #include "Math/Vector.h"
+#include "Math/VectorRegister.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS
+/**
+ * Four-lane versions of the noise kernel for FractalNoiseBatch
+ * Each helper mirrors its scalar counterpart operation for operation so both paths agree
+ */
+namespace TerraScapeNoiseVector
+{
+	FORCEINLINE VectorRegister4Int Hash(VectorRegister4Int Input)
+	{
+		Input = VectorIntXor(Input, VectorShiftRightImmLogical(Input, 16));
+		Input = VectorIntMultiply(Input, VectorIntSet1(static_cast<int32>(0x85ebca6bu)));
+		Input = VectorIntXor(Input, VectorShiftRightImmLogical(Input, 13));
+		Input = VectorIntMultiply(Input, VectorIntSet1(static_cast<int32>(0xc2b2ae35u)));
+		Input = VectorIntXor(Input, VectorShiftRightImmLogical(Input, 16));
+		return Input;
+	}
+
+	FORCEINLINE VectorRegister4Int HashLattice(const VectorRegister4Int& X, const VectorRegister4Int& Y, const VectorRegister4Int& Z, const VectorRegister4Int& SeedHash, const uint8* Permutation)
+	{
+		const VectorRegister4Int Combined = VectorIntXor(
+			VectorIntXor(
+				VectorIntMultiply(X, VectorIntSet1(static_cast<int32>(0x8da6b343u))),
+				VectorIntMultiply(Y, VectorIntSet1(static_cast<int32>(0xd8163841u)))),
+			VectorIntXor(
+				VectorIntMultiply(Z, VectorIntSet1(static_cast<int32>(0xcb1ab31fu))),
+				SeedHash));
+		const VectorRegister4Int Hashed = VectorIntAnd(Hash(Combined), VectorIntSet1(0xFF));
+
+		// The permutation lookup has no vector form, gather the four lanes through memory
+		int32 Lanes[4];
+		VectorIntStore(Hashed, Lanes);
+		return MakeVectorRegisterInt(Permutation[Lanes[0]], Permutation[Lanes[1]], Permutation[Lanes[2]], Permutation[Lanes[3]]);
+	}
+
+	FORCEINLINE VectorRegister4Float GradientDot(const VectorRegister4Int& LatticeHash, const VectorRegister4Float& X, const VectorRegister4Float& Y, const VectorRegister4Float& Z)
+	{
+		const VectorRegister4Int H = VectorIntAnd(LatticeHash, VectorIntSet1(15));
+		const VectorRegister4Int UsesXForV = VectorIntOr(VectorIntCompareEQ(H, VectorIntSet1(12)), VectorIntCompareEQ(H, VectorIntSet1(14)));
+
+		const VectorRegister4Float U = VectorSelect(VectorCastIntToFloat(VectorIntCompareLT(H, VectorIntSet1(8))), X, Y);
+		const VectorRegister4Float V = VectorSelect(VectorCastIntToFloat(VectorIntCompareLT(H, VectorIntSet1(4))), Y,
+			VectorSelect(VectorCastIntToFloat(UsesXForV), X, Z));
+
+		// Bit 0 negates U and bit 1 negates V: flip the float sign bits directly
+		const VectorRegister4Int SignU = VectorShiftLeftImm(VectorIntAnd(H, VectorIntSet1(1)), 31);
+		const VectorRegister4Int SignV = VectorShiftLeftImm(VectorIntAnd(H, VectorIntSet1(2)), 30);
+		return VectorAdd(
+			VectorCastIntToFloat(VectorIntXor(VectorCastFloatToInt(U), SignU)),
+			VectorCastIntToFloat(VectorIntXor(VectorCastFloatToInt(V), SignV)));
+	}
+
+	FORCEINLINE VectorRegister4Float Fade(const VectorRegister4Float& T)
+	{
+		const VectorRegister4Float Inner = VectorAdd(
+			VectorMultiply(T, VectorSubtract(VectorMultiply(T, VectorSetFloat1(6.0f)), VectorSetFloat1(15.0f))),
+			VectorSetFloat1(10.0f));
+		return VectorMultiply(VectorMultiply(VectorMultiply(T, T), T), Inner);
+	}
+
+	FORCEINLINE VectorRegister4Float Lerp(const VectorRegister4Float& A, const VectorRegister4Float& B, const VectorRegister4Float& T)
+	{
+		return VectorAdd(A, VectorMultiply(T, VectorSubtract(B, A)));
+	}
+
+	FORCEINLINE VectorRegister4Float PerlinNoise(const VectorRegister4Float& SampleX, const VectorRegister4Float& SampleY, const VectorRegister4Float& SampleZ, const VectorRegister4Int& SeedHash, const uint8* Permutation)
+	{
+		const VectorRegister4Float FloorX = VectorFloor(SampleX);
+		const VectorRegister4Float FloorY = VectorFloor(SampleY);
+		const VectorRegister4Float FloorZ = VectorFloor(SampleZ);
+
+		const VectorRegister4Int One = VectorIntSet1(1);
+		const VectorRegister4Int X0 = VectorFloatToInt(FloorX);
+		const VectorRegister4Int Y0 = VectorFloatToInt(FloorY);
+		const VectorRegister4Int Z0 = VectorFloatToInt(FloorZ);
+		const VectorRegister4Int X1 = VectorIntAdd(X0, One);
+		const VectorRegister4Int Y1 = VectorIntAdd(Y0, One);
+		const VectorRegister4Int Z1 = VectorIntAdd(Z0, One);
+
+		const VectorRegister4Float FloatOne = VectorSetFloat1(1.0f);
+		const VectorRegister4Float XFrac = VectorSubtract(SampleX, FloorX);
+		const VectorRegister4Float YFrac = VectorSubtract(SampleY, FloorY);
+		const VectorRegister4Float ZFrac = VectorSubtract(SampleZ, FloorZ);
+		const VectorRegister4Float XFrac1 = VectorSubtract(XFrac, FloatOne);
+		const VectorRegister4Float YFrac1 = VectorSubtract(YFrac, FloatOne);
+		const VectorRegister4Float ZFrac1 = VectorSubtract(ZFrac, FloatOne);
+
+		const VectorRegister4Float U = Fade(XFrac);
+		const VectorRegister4Float V = Fade(YFrac);
+		const VectorRegister4Float W = Fade(ZFrac);
+
+		const VectorRegister4Float Dot000 = GradientDot(HashLattice(X0, Y0, Z0, SeedHash, Permutation), XFrac, YFrac, ZFrac);
+		const VectorRegister4Float Dot001 = GradientDot(HashLattice(X0, Y0, Z1, SeedHash, Permutation), XFrac, YFrac, ZFrac1);
+		const VectorRegister4Float Dot010 = GradientDot(HashLattice(X0, Y1, Z0, SeedHash, Permutation), XFrac, YFrac1, ZFrac);
+		const VectorRegister4Float Dot011 = GradientDot(HashLattice(X0, Y1, Z1, SeedHash, Permutation), XFrac, YFrac1, ZFrac1);
+		const VectorRegister4Float Dot100 = GradientDot(HashLattice(X1, Y0, Z0, SeedHash, Permutation), XFrac1, YFrac, ZFrac);
+		const VectorRegister4Float Dot101 = GradientDot(HashLattice(X1, Y0, Z1, SeedHash, Permutation), XFrac1, YFrac, ZFrac1);
+		const VectorRegister4Float Dot110 = GradientDot(HashLattice(X1, Y1, Z0, SeedHash, Permutation), XFrac1, YFrac1, ZFrac);
+		const VectorRegister4Float Dot111 = GradientDot(HashLattice(X1, Y1, Z1, SeedHash, Permutation), XFrac1, YFrac1, ZFrac1);
+
+		const VectorRegister4Float X00 = Lerp(Dot000, Dot100, U);
+		const VectorRegister4Float X01 = Lerp(Dot001, Dot101, U);
+		const VectorRegister4Float X10 = Lerp(Dot010, Dot110, U);
+		const VectorRegister4Float X11 = Lerp(Dot011, Dot111, U);
+
+		return Lerp(Lerp(X00, X10, V), Lerp(X01, X11, V), W);
+	}
+}
+#endif // PLATFORM_ENABLE_VECTORINTRINSICS
 
 UTS_ProceduralNoise::UTS_ProceduralNoise()
 {
 	// Constructor
 }
 
+// Ken Perlin's reference permutation; maps the lattice hash to a gradient index
+const uint8 UTS_ProceduralNoise::Permutation[256] = {
+	151, 160, 137,  91,  90,  15, 131,  13, 201,  95,  96,  53, 194, 233,   7, 225,
+	140,  36, 103,  30,  69, 142,   8,  99,  37, 240,  21,  10,  23, 190,   6, 148,
+	247, 120, 234,  75,   0,  26, 197,  62,  94, 252, 219, 203, 117,  35,  11,  32,
+	 57, 177,  33,  88, 237, 149,  56,  87, 174,  20, 125, 136, 171, 168,  68, 175,
+	 74, 165,  71, 134, 139,  48,  27, 166,  77, 146, 158, 231,  83, 111, 229, 122,
+	 60, 211, 133, 230, 220, 105,  92,  41,  55,  46, 245,  40, 244, 102, 143,  54,
+	 65,  25,  63, 161,   1, 216,  80,  73, 209,  76, 132, 187, 208,  89,  18, 169,
+	200, 196, 135, 130, 116, 188, 159,  86, 164, 100, 109, 198, 173, 186,   3,  64,
+	 52, 217, 226, 250, 124, 123,   5, 202,  38, 147, 118, 126, 255,  82,  85, 212,
+	207, 206,  59, 227,  47,  16,  58,  17, 182, 189,  28,  42, 223, 183, 170, 213,
+	119, 248, 152,   2,  44, 154, 163,  70, 221, 153, 101, 155, 167,  43, 172,   9,
+	129,  22,  39, 253,  19,  98, 108, 110,  79, 113, 224, 232, 178, 185, 112, 104,
+	218, 246,  97, 228, 251,  34, 242, 193, 238, 210, 144,  12, 191, 179, 162, 241,
+	 81,  51, 145, 235, 249,  14, 239, 107,  49, 192, 214,  31, 181, 199, 106, 157,
+	184,  84, 204, 176, 115, 121,  50,  45, 127,   4, 150, 254, 138, 236, 205,  93,
+	222, 114,  67,  29,  24,  72, 243, 141, 128, 195,  78,  66, 215,  61, 156, 180
+};
+
 float UTS_ProceduralNoise::PerlinNoise(float X, float Y, float Z, const FTS_NoiseParameters& Parameters)
 {
-	// Apply frequency and offset
-	float SampleX = (X + Parameters.Offset.X) * Parameters.Frequency;
-	float SampleY = (Y + Parameters.Offset.Y) * Parameters.Frequency;
-	float SampleZ = (Z + Parameters.Offset.Z) * Parameters.Frequency;
+	// Apply frequency and offset (in float, like FractalNoiseBatch)
+	float SampleX = (X + static_cast<float>(Parameters.Offset.X)) * Parameters.Frequency;
+	float SampleY = (Y + static_cast<float>(Parameters.Offset.Y)) * Parameters.Frequency;
+	float SampleZ = (Z + static_cast<float>(Parameters.Offset.Z)) * Parameters.Frequency;
 
 	// Get integer coordinates
 	int32 X0 = FMath::FloorToInt(SampleX);
@@ -32,64 +162,18 @@ float UTS_ProceduralNoise::PerlinNoise(float X, float Y, float Z, const FTS_Nois
 	float V = Fade(YFrac);
 	float W = Fade(ZFrac);
 
-	// Generate gradient vectors for each corner
-	FVector Grad000 = FVector(
-		FMath::FRandRange(-1.0f, 1.0f),
-		FMath::FRandRange(-1.0f, 1.0f),
-		FMath::FRandRange(-1.0f, 1.0f)
-	).GetSafeNormal();
-
-	FVector Grad001 = FVector(
-		FMath::FRandRange(-1.0f, 1.0f),
-		FMath::FRandRange(-1.0f, 1.0f),
-		FMath::FRandRange(-1.0f, 1.0f)
-	).GetSafeNormal();
-
-	FVector Grad010 = FVector(
-		FMath::FRandRange(-1.0f, 1.0f),
-		FMath::FRandRange(-1.0f, 1.0f),
-		FMath::FRandRange(-1.0f, 1.0f)
-	).GetSafeNormal();
-
-	FVector Grad011 = FVector(
-		FMath::FRandRange(-1.0f, 1.0f),
-		FMath::FRandRange(-1.0f, 1.0f),
-		FMath::FRandRange(-1.0f, 1.0f)
-	).GetSafeNormal();
-
-	FVector Grad100 = FVector(
-		FMath::FRandRange(-1.0f, 1.0f),
-		FMath::FRandRange(-1.0f, 1.0f),
-		FMath::FRandRange(-1.0f, 1.0f)
-	).GetSafeNormal();
-
-	FVector Grad101 = FVector(
-		FMath::FRandRange(-1.0f, 1.0f),
-		FMath::FRandRange(-1.0f, 1.0f),
-		FMath::FRandRange(-1.0f, 1.0f)
-	).GetSafeNormal();
-
-	FVector Grad110 = FVector(
-		FMath::FRandRange(-1.0f, 1.0f),
-		FMath::FRandRange(-1.0f, 1.0f),
-		FMath::FRandRange(-1.0f, 1.0f)
-	).GetSafeNormal();
-
-	FVector Grad111 = FVector(
-		FMath::FRandRange(-1.0f, 1.0f),
-		FMath::FRandRange(-1.0f, 1.0f),
-		FMath::FRandRange(-1.0f, 1.0f)
-	).GetSafeNormal();
-
-	// Calculate dot products
-	float Dot000 = FVector::DotProduct(Grad000, FVector(XFrac, YFrac, ZFrac));
-	float Dot001 = FVector::DotProduct(Grad001, FVector(XFrac, YFrac, ZFrac - 1.0f));
-	float Dot010 = FVector::DotProduct(Grad010, FVector(XFrac, YFrac - 1.0f, ZFrac));
-	float Dot011 = FVector::DotProduct(Grad011, FVector(XFrac, YFrac - 1.0f, ZFrac - 1.0f));
-	float Dot100 = FVector::DotProduct(Grad100, FVector(XFrac - 1.0f, YFrac, ZFrac));
-	float Dot101 = FVector::DotProduct(Grad101, FVector(XFrac - 1.0f, YFrac, ZFrac - 1.0f));
-	float Dot110 = FVector::DotProduct(Grad110, FVector(XFrac - 1.0f, YFrac - 1.0f, ZFrac));
-	float Dot111 = FVector::DotProduct(Grad111, FVector(XFrac - 1.0f, YFrac - 1.0f, ZFrac - 1.0f));
+	// Gradients come from the seeded lattice hash, so the result only depends on the inputs
+	const uint32 SeedHash = Hash(static_cast<uint32>(Parameters.Seed));
+
+	// Calculate dot products with the corner gradients
+	float Dot000 = GradientDot(HashLattice(X0, Y0, Z0, SeedHash), XFrac, YFrac, ZFrac);
+	float Dot001 = GradientDot(HashLattice(X0, Y0, Z1, SeedHash), XFrac, YFrac, ZFrac - 1.0f);
+	float Dot010 = GradientDot(HashLattice(X0, Y1, Z0, SeedHash), XFrac, YFrac - 1.0f, ZFrac);
+	float Dot011 = GradientDot(HashLattice(X0, Y1, Z1, SeedHash), XFrac, YFrac - 1.0f, ZFrac - 1.0f);
+	float Dot100 = GradientDot(HashLattice(X1, Y0, Z0, SeedHash), XFrac - 1.0f, YFrac, ZFrac);
+	float Dot101 = GradientDot(HashLattice(X1, Y0, Z1, SeedHash), XFrac - 1.0f, YFrac, ZFrac - 1.0f);
+	float Dot110 = GradientDot(HashLattice(X1, Y1, Z0, SeedHash), XFrac - 1.0f, YFrac - 1.0f, ZFrac);
+	float Dot111 = GradientDot(HashLattice(X1, Y1, Z1, SeedHash), XFrac - 1.0f, YFrac - 1.0f, ZFrac - 1.0f);
 
 	// Trilinear interpolation
 	float X00 = Lerp(Dot000, Dot100, U);
@@ -169,32 +253,53 @@ float UTS_ProceduralNoise::SimplexNoise(float X, float Y, float Z, const FTS_Noi
 		}
 	}
 
+	// Offsets of the remaining three corners in unskewed space
+	float X1_ = X0_ - I1 + G3;
+	float Y1_ = Y0_ - J1 + G3;
+	float Z1_ = Z0_ - K1 + G3;
+	float X2_ = X0_ - I2 + 2.0f * G3;
+	float Y2_ = Y0_ - J2 + 2.0f * G3;
+	float Z2_ = Z0_ - K2 + 2.0f * G3;
+	float X3_ = X0_ - 1.0f + 3.0f * G3;
+	float Y3_ = Y0_ - 1.0f + 3.0f * G3;
+	float Z3_ = Z0_ - 1.0f + 3.0f * G3;
+
+	const uint32 SeedHash = Hash(static_cast<uint32>(Parameters.Seed));
+
 	// Calculate noise contribution from each corner
 	float T0 = 0.6f - X0_ * X0_ - Y0_ * Y0_ - Z0_ * Z0_;
 	float N0 = 0.0f;
 	if (T0 >= 0.0f)
 	{
 		T0 *= T0;
-		N0 = T0 * T0 * FMath::FRandRange(-1.0f, 1.0f);
+		N0 = T0 * T0 * GradientDot(HashLattice(I, J, K, SeedHash), X0_, Y0_, Z0_);
 	}
 
-	float T1 = 0.6f - (X0_ - I1) * (X0_ - I1) - (Y0_ - J1) * (Y0_ - J1) - (Z0_ - K1) * (Z0_ - K1);
+	float T1 = 0.6f - X1_ * X1_ - Y1_ * Y1_ - Z1_ * Z1_;
 	float N1 = 0.0f;
 	if (T1 >= 0.0f)
 	{
 		T1 *= T1;
-		N1 = T1 * T1 * FMath::FRandRange(-1.0f, 1.0f);
+		N1 = T1 * T1 * GradientDot(HashLattice(I + I1, J + J1, K + K1, SeedHash), X1_, Y1_, Z1_);
 	}
 
-	float T2 = 0.6f - (X0_ - I2) * (X0_ - I2) - (Y0_ - J2) * (Y0_ - J2) - (Z0_ - K2) * (Z0_ - K2);
+	float T2 = 0.6f - X2_ * X2_ - Y2_ * Y2_ - Z2_ * Z2_;
 	float N2 = 0.0f;
 	if (T2 >= 0.0f)
 	{
 		T2 *= T2;
-		N2 = T2 * T2 * FMath::FRandRange(-1.0f, 1.0f);
+		N2 = T2 * T2 * GradientDot(HashLattice(I + I2, J + J2, K + K2, SeedHash), X2_, Y2_, Z2_);
 	}
 
-	return 32.0f * (N0 + N1 + N2);
+	float T3 = 0.6f - X3_ * X3_ - Y3_ * Y3_ - Z3_ * Z3_;
+	float N3 = 0.0f;
+	if (T3 >= 0.0f)
+	{
+		T3 *= T3;
+		N3 = T3 * T3 * GradientDot(HashLattice(I + 1, J + 1, K + 1, SeedHash), X3_, Y3_, Z3_);
+	}
+
+	return 32.0f * (N0 + N1 + N2 + N3);
 }
 
 float UTS_ProceduralNoise::FractalNoise(float X, float Y, float Z, const FTS_NoiseParameters& Parameters)
@@ -220,6 +325,90 @@ float UTS_ProceduralNoise::FractalNoise(float X, float Y, float Z, const FTS_Noi
 	return Value / MaxValue;
 }
 
+void UTS_ProceduralNoise::FractalNoiseBatch(const FVector& Start, const FVector& Step, const FTS_NoiseParameters& Parameters, TArrayView<float> OutValues)
+{
+	const int32 Count = OutValues.Num();
+	const float StartX = static_cast<float>(Start.X);
+	const float StartY = static_cast<float>(Start.Y);
+	const float StartZ = static_cast<float>(Start.Z);
+	const float StepX = static_cast<float>(Step.X);
+	const float StepY = static_cast<float>(Step.Y);
+	const float StepZ = static_cast<float>(Step.Z);
+
+	int32 Index = 0;
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS
+	const VectorRegister4Float OffsetX = VectorSetFloat1(static_cast<float>(Parameters.Offset.X));
+	const VectorRegister4Float OffsetY = VectorSetFloat1(static_cast<float>(Parameters.Offset.Y));
+	const VectorRegister4Float OffsetZ = VectorSetFloat1(static_cast<float>(Parameters.Offset.Z));
+	const VectorRegister4Int SeedHash = VectorIntSet1(static_cast<int32>(Hash(static_cast<uint32>(Parameters.Seed))));
+	const VectorRegister4Float LaneOffsets = MakeVectorRegisterFloat(0.0f, 1.0f, 2.0f, 3.0f);
+
+	for (; Index + 4 <= Count; Index += 4)
+	{
+		const VectorRegister4Float Lanes = VectorAdd(VectorSetFloat1(static_cast<float>(Index)), LaneOffsets);
+		const VectorRegister4Float X = VectorAdd(VectorSetFloat1(StartX), VectorMultiply(VectorSetFloat1(StepX), Lanes));
+		const VectorRegister4Float Y = VectorAdd(VectorSetFloat1(StartY), VectorMultiply(VectorSetFloat1(StepY), Lanes));
+		const VectorRegister4Float Z = VectorAdd(VectorSetFloat1(StartZ), VectorMultiply(VectorSetFloat1(StepZ), Lanes));
+
+		VectorRegister4Float Value = VectorZeroFloat();
+		float Amplitude = Parameters.Amplitude;
+		float Frequency = Parameters.Frequency;
+		float MaxValue = 0.0f;
+
+		for (int32 i = 0; i < Parameters.Octaves; i++)
+		{
+			const VectorRegister4Float OctaveFrequency = VectorSetFloat1(Frequency);
+			const VectorRegister4Float Noise = TerraScapeNoiseVector::PerlinNoise(
+				VectorMultiply(VectorAdd(X, OffsetX), OctaveFrequency),
+				VectorMultiply(VectorAdd(Y, OffsetY), OctaveFrequency),
+				VectorMultiply(VectorAdd(Z, OffsetZ), OctaveFrequency),
+				SeedHash, Permutation);
+
+			Value = VectorAdd(Value, VectorMultiply(Noise, VectorSetFloat1(Amplitude)));
+			MaxValue += Amplitude;
+
+			Amplitude *= Parameters.Persistence;
+			Frequency *= Parameters.Lacunarity;
+		}
+
+		VectorStore(VectorDivide(Value, VectorSetFloat1(MaxValue)), OutValues.GetData() + Index);
+	}
+#endif
+
+	// Scalar fallback and the remainder of the run
+	for (; Index < Count; Index++)
+	{
+		const float Lane = static_cast<float>(Index);
+		OutValues[Index] = FractalNoise(StartX + StepX * Lane, StartY + StepY * Lane, StartZ + StepZ * Lane, Parameters);
+	}
+}
+
+void UTS_ProceduralNoise::GetTerrainHeightBatch(const FVector& Start, const FVector& Step, const FTS_NoiseParameters& Parameters, TArrayView<float> OutHeights)
+{
+	// Use 2D noise for terrain height
+	FractalNoiseBatch(FVector(Start.X, Start.Y, 0.0f), FVector(Step.X, Step.Y, 0.0f), Parameters, OutHeights);
+
+	for (float& Height : OutHeights)
+	{
+		// Same scaling as GetTerrainHeight
+		Height *= Parameters.Amplitude;
+		Height += 100.0f;
+	}
+}
+
+void UTS_ProceduralNoise::GetCaveDensityBatch(const FVector& Start, const FVector& Step, const FTS_NoiseParameters& Parameters, TArrayView<float> OutDensities)
+{
+	FractalNoiseBatch(Start, Step, Parameters, OutDensities);
+
+	for (float& Density : OutDensities)
+	{
+		// Same thresholding as GetCaveDensity
+		const float Normalized = (Density + 1.0f) * 0.5f;
+		Density = Normalized > 0.3f ? 1.0f : 0.0f;
+	}
+}
+
 float UTS_ProceduralNoise::CombineNoiseLayers(float X, float Y, float Z, const TArray<FTS_NoiseLayer>& Layers)
 {
 	float TotalValue = 0.0f;
@@ -276,6 +465,25 @@ uint32 UTS_ProceduralNoise::Hash(uint32 Input)
 	return Input;
 }
 
+uint32 UTS_ProceduralNoise::HashLattice(int32 X, int32 Y, int32 Z, uint32 SeedHash)
+{
+	// Fold the lattice coordinates into one word with large odd multipliers, mix, then permute
+	const uint32 Combined = (static_cast<uint32>(X) * 0x8da6b343u)
+		^ (static_cast<uint32>(Y) * 0xd8163841u)
+		^ (static_cast<uint32>(Z) * 0xcb1ab31fu)
+		^ SeedHash;
+	return Permutation[Hash(Combined) & 0xFF];
+}
+
+float UTS_ProceduralNoise::GradientDot(uint32 LatticeHash, float X, float Y, float Z)
+{
+	// Improved Perlin gradients: the 12 cube edge directions (4 repeated to fill 16 slots)
+	const uint32 H = LatticeHash & 15;
+	const float U = H < 8 ? X : Y;
+	const float V = H < 4 ? Y : (H == 12 || H == 14 ? X : Z);
+	return ((H & 1) ? -U : U) + ((H & 2) ? -V : V);
+}
+
 float UTS_ProceduralNoise::Lerp(float A, float B, float T)
 {
 	return A + T * (B - A);
@@ -120,6 +120,35 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "TerraScape | Voxel | Procedural")
 	static float FractalNoise(float X, float Y, float Z, const FTS_NoiseParameters& Parameters);
 
+	/**
+	 * Generate fractal noise for a strided run of points (e.g. one row of voxels)
+	 * Point i is Start + Step * i. Four points are evaluated at once through VectorRegister
+	 * math when vector intrinsics are available; the remainder uses the scalar kernel.
+	 * @param Start - World coordinates of the first point
+	 * @param Step - World space step between consecutive points
+	 * @param Parameters - Noise parameters
+	 * @param OutValues - Output noise values, one per point (its size is the run length)
+	 */
+	static void FractalNoiseBatch(const FVector& Start, const FVector& Step, const FTS_NoiseParameters& Parameters, TArrayView<float> OutValues);
+
+	/**
+	 * Batch version of GetTerrainHeight for a strided run of points
+	 * @param Start - World coordinates of the first point (Z is ignored)
+	 * @param Step - World space step between consecutive points
+	 * @param Parameters - Noise parameters
+	 * @param OutHeights - Output heights, one per point
+	 */
+	static void GetTerrainHeightBatch(const FVector& Start, const FVector& Step, const FTS_NoiseParameters& Parameters, TArrayView<float> OutHeights);
+
+	/**
+	 * Batch version of GetCaveDensity for a strided run of points
+	 * @param Start - World coordinates of the first point
+	 * @param Step - World space step between consecutive points
+	 * @param Parameters - Noise parameters
+	 * @param OutDensities - Output cave densities, one per point
+	 */
+	static void GetCaveDensityBatch(const FVector& Start, const FVector& Step, const FTS_NoiseParameters& Parameters, TArrayView<float> OutDensities);
+
 	/**
 	 * Combine multiple noise layers
 	 * @param X, Y, Z - World coordinates
@@ -153,6 +182,25 @@ private:
 	 */
 	static uint32 Hash(uint32 Input);
 
+	/**
+	 * Seeded hash of an integer lattice point
+	 * Pure function of its inputs, so noise is reentrant and identical on every thread
+	 * @param X, Y, Z - Lattice coordinates
+	 * @param SeedHash - Hash of the noise seed
+	 * @return Gradient index source (0-255)
+	 */
+	static uint32 HashLattice(int32 X, int32 Y, int32 Z, uint32 SeedHash);
+
+	/**
+	 * Dot product of the lattice gradient selected by a hash with an offset vector
+	 */
+	static float GradientDot(uint32 LatticeHash, float X, float Y, float Z);
+
+	/**
+	 * Permutation table used by HashLattice
+	 */
+	static const uint8 Permutation[256];
+
 	/**
 	 * Linear interpolation
 	 */
@@ -0,0 +1,724 @@
+/**
+ * @file TS_RegionFile.cpp
+ * @brief Region files storing compressed chunk voxel data on disk
+ * @author Keves
+ * @version 1.0
+ */
+
+#include "TS_RegionFile.h"
+#include "TS_Stats.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/AsyncWork.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/Event.h"
+#include "Misc/Compression.h"
+#include "Misc/Crc.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+/**
+ * @brief Writes a chunk's queued save to its region file on a worker thread
+ */
+class FTS_AsyncChunkSaveTask : public FNonAbandonableTask
+{
+public:
+	FTS_AsyncChunkSaveTask(FTS_RegionStore* InStore, const FIntVector& InChunkID)
+		: Store(InStore)
+		, ChunkID(InChunkID)
+	{
+	}
+
+	// FNonAbandonableTask interface
+	void DoWork()
+	{
+		Store->CompletePendingSave(ChunkID);
+	}
+
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FTS_AsyncChunkSaveTask, STATGROUP_TerraScape);
+	}
+
+private:
+	/** Not owned: the store waits for its save tasks before it goes away, so no worker ever destroys it */
+	FTS_RegionStore* Store;
+	FIntVector ChunkID;
+};
+
+FTS_RegionFile::~FTS_RegionFile()
+{
+	Close();
+}
+
+bool FTS_RegionFile::Open(const FString& InFilename, int32 InChunkSize, uint32 InGeneratorFingerprint, FName InCompressionFormat, bool bCreate)
+{
+	Close();
+	Filename = InFilename;
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	FHeader Header;
+	Entries.SetNum(ChunksPerRegion);
+
+	bool bNewFile = !PlatformFile.FileExists(*Filename);
+	if (!bNewFile)
+	{
+		TUniquePtr<IFileHandle> ReadHandle(PlatformFile.OpenRead(*Filename));
+		if (!ReadHandle || ReadHandle->Size() < int64(sizeof(FHeader))
+			|| !ReadHandle->Read(reinterpret_cast<uint8*>(&Header), sizeof(FHeader)))
+		{
+			UE_LOG(LogTerraScape, Warning, TEXT("TerraScape: Could not read region file %s"), *Filename);
+			Close();
+			return false;
+		}
+		FileSize = ReadHandle->Size();
+
+		// Chunks from another seed, generator setup or chunk layout wouldn't line up with freshly generated ones
+		bool bStale = true;
+		if (Header.Magic != FileMagic || Header.Version != FileVersion || Header.ChunkSize != InChunkSize
+			|| (Header.CompressionFormat != 0 && GetFormatName(Header.CompressionFormat).IsNone()))
+		{
+			UE_LOG(LogTerraScape, Warning, TEXT("TerraScape: Ignoring region file %s (version %u, chunk size %d, expected version %u, chunk size %d)"),
+				*Filename, Header.Version, Header.ChunkSize, FileVersion, InChunkSize);
+		}
+		else if (Header.GeneratorFingerprint != InGeneratorFingerprint)
+		{
+			UE_LOG(LogTerraScape, Warning, TEXT("TerraScape: Ignoring region file %s, made with other world generation settings (fingerprint %08x, expected %08x)"),
+				*Filename, Header.GeneratorFingerprint, InGeneratorFingerprint);
+		}
+		else
+		{
+			bStale = false;
+		}
+
+		// Nothing could ever be saved into a stale file: keep it around for the user and start the region over
+		if (bStale)
+		{
+			ReadHandle.Reset();
+			if (!bCreate || !MoveAside())
+			{
+				Close();
+				return false;
+			}
+			bNewFile = true;
+		}
+	}
+
+	if (bNewFile)
+	{
+		if (!bCreate)
+		{
+			Entries.Empty();
+			return false;
+		}
+
+		// Just the header, the first record goes right after it
+		PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Filename));
+		WriteHandle.Reset(PlatformFile.OpenWrite(*Filename, false, true));
+		Header = FHeader();
+		Header.Magic = FileMagic;
+		Header.Version = FileVersion;
+		Header.ChunkSize = InChunkSize;
+		Header.CompressionFormat = GetFormatID(InCompressionFormat);
+		Header.GeneratorFingerprint = InGeneratorFingerprint;
+		if (!WriteHandle || !WriteHandle->Write(reinterpret_cast<const uint8*>(&Header), sizeof(FHeader)))
+		{
+			UE_LOG(LogTerraScape, Warning, TEXT("TerraScape: Could not create region file %s"), *Filename);
+			Close();
+			return false;
+		}
+		FileSize = sizeof(FHeader);
+	}
+
+	const uint32 FormatID = Header.CompressionFormat;
+	CompressionFormat = GetFormatName(FormatID);
+
+	// Reads fall back to a file handle if the platform can't map the file
+	bool bReadRecords = true;
+	{
+		FWriteScopeLock EntriesScope(EntriesLock);
+		Remap();
+		if (!bNewFile)
+		{
+			bReadRecords = ReadRecords();
+		}
+	}
+	if (!bReadRecords)
+	{
+		UE_LOG(LogTerraScape, Warning, TEXT("TerraScape: Could not read region file %s"), *Filename);
+		Close();
+		return false;
+	}
+	return true;
+}
+
+bool FTS_RegionFile::ReadRecords()
+{
+	TUniquePtr<IFileHandle> ReadHandle;
+	if (!MappedRegion)
+	{
+		ReadHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Filename, true));
+		if (!ReadHandle)
+		{
+			return false;
+		}
+	}
+
+	// Stop at the first record that runs past the end or makes no sense: that's where a write was cut short
+	const int64 EndOfFile = MappedRegion ? MappedSize : ReadHandle->Size();
+	int64 Offset = sizeof(FHeader);
+	while (Offset + int64(sizeof(FRecordHeader)) <= EndOfFile)
+	{
+		FRecordHeader Record;
+		if (MappedRegion)
+		{
+			FMemory::Memcpy(&Record, MappedRegion->GetMappedPtr() + Offset, sizeof(FRecordHeader));
+		}
+		else if (!ReadHandle->Seek(Offset) || !ReadHandle->Read(reinterpret_cast<uint8*>(&Record), sizeof(FRecordHeader)))
+		{
+			break;
+		}
+
+		const int64 PayloadOffset = Offset + sizeof(FRecordHeader);
+		if (Record.LocalIndex >= uint32(ChunksPerRegion) || Record.CompressedSize == 0
+			|| PayloadOffset + Record.CompressedSize > EndOfFile)
+		{
+			break;
+		}
+
+		// Later records of a chunk replace earlier ones
+		FEntry& Entry = Entries[Record.LocalIndex];
+		Entry.Offset = PayloadOffset;
+		Entry.CompressedSize = Record.CompressedSize;
+		Entry.UncompressedSize = Record.UncompressedSize;
+		Entry.Crc = Record.Crc;
+		Offset = PayloadOffset + Record.CompressedSize;
+	}
+
+	if (Offset < EndOfFile)
+	{
+		UE_LOG(LogTerraScape, Warning, TEXT("TerraScape: Region file %s ends in an incomplete record, dropping its last %lld bytes"),
+			*Filename, EndOfFile - Offset);
+	}
+	FileSize = Offset;
+	return true;
+}
+
+bool FTS_RegionFile::MoveAside()
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const FString StaleFilename = Filename + TEXT(".stale");
+
+	// Only the most recent stale version of a region is kept
+	PlatformFile.DeleteFile(*StaleFilename);
+	if (!PlatformFile.MoveFile(*StaleFilename, *Filename))
+	{
+		UE_LOG(LogTerraScape, Error, TEXT("TerraScape: Could not move stale region file %s aside, chunks of its region won't be saved"), *Filename);
+		return false;
+	}
+
+	UE_LOG(LogTerraScape, Warning, TEXT("TerraScape: Moved stale region file %s to %s, starting the region over"), *Filename, *StaleFilename);
+	return true;
+}
+
+void FTS_RegionFile::Close()
+{
+	{
+		FScopeLock WriteScope(&WriteLock);
+		if (WriteHandle)
+		{
+			WriteHandle->Flush();
+			WriteHandle.Reset();
+		}
+	}
+
+	FWriteScopeLock EntriesScope(EntriesLock);
+	MappedRegion.Reset();
+	MappedHandle.Reset();
+	MappedSize = 0;
+	Entries.Empty();
+	FileSize = 0;
+}
+
+bool FTS_RegionFile::HasChunk(int32 LocalIndex) const
+{
+	FReadScopeLock EntriesScope(EntriesLock);
+	return Entries.IsValidIndex(LocalIndex) && Entries[LocalIndex].CompressedSize > 0;
+}
+
+bool FTS_RegionFile::ReadChunk(int32 LocalIndex, TArray<uint8>& OutData)
+{
+	FEntry Entry;
+	for (int32 Attempt = 0; Attempt < 2; Attempt++)
+	{
+		{
+			FReadScopeLock EntriesScope(EntriesLock);
+			if (!Entries.IsValidIndex(LocalIndex) || Entries[LocalIndex].CompressedSize == 0)
+			{
+				return false;
+			}
+
+			// Decompress straight from the mapping, no intermediate copy of the compressed bytes
+			Entry = Entries[LocalIndex];
+			if (MappedRegion && Entry.Offset + Entry.CompressedSize <= uint64(MappedSize))
+			{
+				return Decompress(MappedRegion->GetMappedPtr() + Entry.Offset, Entry, OutData);
+			}
+		}
+
+		// Appended after the file was last mapped
+		if (Attempt == 0)
+		{
+			FWriteScopeLock EntriesScope(EntriesLock);
+			if (!MappedRegion || Entry.Offset + Entry.CompressedSize > uint64(MappedSize))
+			{
+				Remap();
+			}
+		}
+	}
+
+	TArray<uint8> Compressed;
+	return ReadUnmapped(Entry, Compressed) && Decompress(Compressed.GetData(), Entry, OutData);
+}
+
+bool FTS_RegionFile::WriteChunk(int32 LocalIndex, TArrayView<const uint8> Data)
+{
+	if (!Entries.IsValidIndex(LocalIndex) || Data.Num() == 0)
+	{
+		return false;
+	}
+
+	// Compress before taking the lock, so saves to the same region only queue up for the file write
+	TArray<uint8> Compressed;
+	if (CompressionFormat.IsNone())
+	{
+		Compressed = Data;
+	}
+	else
+	{
+		int32 CompressedSize = FCompression::CompressMemoryBound(CompressionFormat, Data.Num());
+		Compressed.SetNumUninitialized(CompressedSize);
+		if (!FCompression::CompressMemory(CompressionFormat, Compressed.GetData(), CompressedSize, Data.GetData(), Data.Num()))
+		{
+			return false;
+		}
+		Compressed.SetNum(CompressedSize, EAllowShrinking::No);
+	}
+
+	FRecordHeader Record;
+	Record.LocalIndex = LocalIndex;
+	Record.CompressedSize = Compressed.Num();
+	Record.UncompressedSize = Data.Num();
+	Record.Crc = FCrc::MemCrc32(Compressed.GetData(), Compressed.Num());
+
+	FScopeLock WriteScope(&WriteLock);
+	if (!WriteHandle)
+	{
+		// Append mode keeps the existing contents; every write lands at the end, which is where records go
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		WriteHandle.Reset(PlatformFile.OpenWrite(*Filename, true, true));
+		if (!WriteHandle)
+		{
+			UE_LOG(LogTerraScape, Warning, TEXT("TerraScape: Could not open region file %s for writing"), *Filename);
+			return false;
+		}
+
+		// An incomplete record at the end would hide every record appended after it. Some platforms can't
+		// shrink a mapped file, so drop the mapping (the next read maps it again), then reopen at the new end
+		if (WriteHandle->Size() != FileSize)
+		{
+			{
+				FWriteScopeLock EntriesScope(EntriesLock);
+				MappedRegion.Reset();
+				MappedHandle.Reset();
+				MappedSize = 0;
+			}
+
+			const bool bTruncated = WriteHandle->Truncate(FileSize);
+			WriteHandle.Reset(bTruncated ? PlatformFile.OpenWrite(*Filename, true, true) : nullptr);
+			if (!WriteHandle || WriteHandle->Size() != FileSize)
+			{
+				UE_LOG(LogTerraScape, Warning, TEXT("TerraScape: Could not truncate region file %s to its last complete record"), *Filename);
+				WriteHandle.Reset();
+				return false;
+			}
+		}
+	}
+
+	FEntry Entry;
+	Entry.Offset = FileSize + sizeof(FRecordHeader);
+	Entry.CompressedSize = Record.CompressedSize;
+	Entry.UncompressedSize = Record.UncompressedSize;
+	Entry.Crc = Record.Crc;
+
+	// Until the whole record is written, opening the file ignores it and the chunk keeps its previous version
+	if (!WriteHandle->Write(reinterpret_cast<const uint8*>(&Record), sizeof(FRecordHeader))
+		|| !WriteHandle->Write(Compressed.GetData(), Compressed.Num()))
+	{
+		// Reopened (and truncated back to the last complete record) by the next write
+		UE_LOG(LogTerraScape, Warning, TEXT("TerraScape: Write to region file %s failed"), *Filename);
+		WriteHandle.Reset();
+		return false;
+	}
+	FileSize += sizeof(FRecordHeader) + Compressed.Num();
+
+	FWriteScopeLock EntriesScope(EntriesLock);
+	Entries[LocalIndex] = Entry;
+	return true;
+}
+
+void FTS_RegionFile::Flush()
+{
+	FScopeLock WriteScope(&WriteLock);
+	if (WriteHandle)
+	{
+		WriteHandle->Flush();
+	}
+}
+
+bool FTS_RegionFile::Remap()
+{
+	MappedRegion.Reset();
+	MappedHandle.Reset();
+	MappedSize = 0;
+
+	FOpenMappedResult Result = FPlatformFileManager::Get().GetPlatformFile().OpenMappedEx(*Filename);
+	if (Result.HasError())
+	{
+		return false;
+	}
+
+	MappedHandle = Result.StealValue();
+	const int64 Size = MappedHandle->GetFileSize();
+	MappedRegion.Reset(MappedHandle->MapRegion(0, Size));
+	if (!MappedRegion)
+	{
+		MappedHandle.Reset();
+		return false;
+	}
+
+	MappedSize = Size;
+	return true;
+}
+
+bool FTS_RegionFile::ReadUnmapped(const FEntry& Entry, TArray<uint8>& OutCompressed) const
+{
+	TUniquePtr<IFileHandle> ReadHandle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Filename, true));
+	OutCompressed.SetNumUninitialized(Entry.CompressedSize);
+	return ReadHandle && ReadHandle->Seek(Entry.Offset) && ReadHandle->Read(OutCompressed.GetData(), Entry.CompressedSize);
+}
+
+bool FTS_RegionFile::Decompress(const uint8* Compressed, const FEntry& Entry, TArray<uint8>& OutData) const
+{
+	// Complete on disk but not what was written, e.g. the payload never reached the disk before a crash
+	if (FCrc::MemCrc32(Compressed, Entry.CompressedSize) != Entry.Crc)
+	{
+		return false;
+	}
+
+	OutData.SetNumUninitialized(Entry.UncompressedSize);
+	if (CompressionFormat.IsNone())
+	{
+		if (Entry.CompressedSize != Entry.UncompressedSize)
+		{
+			return false;
+		}
+		FMemory::Memcpy(OutData.GetData(), Compressed, Entry.UncompressedSize);
+		return true;
+	}
+	return FCompression::UncompressMemory(CompressionFormat, OutData.GetData(), Entry.UncompressedSize, Compressed, Entry.CompressedSize);
+}
+
+uint32 FTS_RegionFile::GetFormatID(FName Format)
+{
+	if (Format == NAME_LZ4)
+	{
+		return 1;
+	}
+	if (Format == NAME_Oodle)
+	{
+		return 2;
+	}
+	if (Format == NAME_Zlib)
+	{
+		return 3;
+	}
+	return 0; // Stored uncompressed
+}
+
+FName FTS_RegionFile::GetFormatName(uint32 FormatID)
+{
+	switch (FormatID)
+	{
+		case 1: return NAME_LZ4;
+		case 2: return NAME_Oodle;
+		case 3: return NAME_Zlib;
+		default: return NAME_None;
+	}
+}
+
+FTS_RegionStore::FTS_RegionStore(const FString& InDirectory, int32 InChunkSize, uint32 InGeneratorFingerprint, FName InCompressionFormat)
+	: Directory(InDirectory)
+	, ChunkSize(InChunkSize)
+	, GeneratorFingerprint(InGeneratorFingerprint)
+	, CompressionFormat(InCompressionFormat)
+{
+	SavesDoneEvent = FPlatformProcess::GetSynchEventFromPool(true);
+	SavesDoneEvent->Trigger();
+}
+
+FTS_RegionStore::~FTS_RegionStore()
+{
+	WaitForPendingSaves();
+
+	if (FailedSaves.Num() > 0)
+	{
+		UE_LOG(LogTerraScape, Error, TEXT("TerraScape: %d chunks could not be saved to %s, their changes are lost"), FailedSaves.Num(), *Directory);
+	}
+
+	FScopeLock RegionsScope(&RegionsLock);
+	for (auto& RegionPair : Regions)
+	{
+		if (RegionPair.Value.File.IsValid())
+		{
+			RegionPair.Value.File->Close();
+		}
+	}
+	Regions.Empty();
+
+	FPlatformProcess::ReturnSynchEventToPool(SavesDoneEvent);
+	SavesDoneEvent = nullptr;
+}
+
+bool FTS_RegionStore::LoadChunk(const FIntVector& ChunkID, FTS_ChunkVoxelStorage& OutStorage, bool& bOutIsUniform, int32& OutUniformMaterialID,
+	bool* bOutUnsaved)
+{
+	// A save still on its way to disk, or one that never got there, is the latest version
+	{
+		FScopeLock PendingScope(&PendingSavesLock);
+		const FPendingSave* Pending = PendingSaves.Find(ChunkID);
+		if (!Pending)
+		{
+			Pending = FailedSaves.Find(ChunkID);
+		}
+		if (bOutUnsaved)
+		{
+			*bOutUnsaved = Pending != nullptr;
+		}
+		if (Pending)
+		{
+			bOutIsUniform = !Pending->Storage.IsValid();
+			OutUniformMaterialID = Pending->UniformMaterialID;
+			OutStorage = bOutIsUniform ? FTS_ChunkVoxelStorage() : *Pending->Storage;
+			return true;
+		}
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(FTS_RegionStore::LoadChunk);
+	TSharedPtr<FTS_RegionFile, ESPMode::ThreadSafe> RegionFile = GetRegionFile(FTS_RegionFile::GetRegionID(ChunkID), false);
+	TArray<uint8> Payload;
+	if (!RegionFile.IsValid() || !RegionFile->ReadChunk(FTS_RegionFile::GetLocalIndex(ChunkID), Payload))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Payload);
+	SerializeChunk(Reader, OutStorage, bOutIsUniform, OutUniformMaterialID);
+	if (Reader.IsError() || (!bOutIsUniform && OutStorage.GetChunkSize() != ChunkSize))
+	{
+		UE_LOG(LogTerraScape, Warning, TEXT("TerraScape: Stored chunk %s is corrupt, regenerating it"), *ChunkID.ToString());
+		OutStorage = FTS_ChunkVoxelStorage();
+		return false;
+	}
+	return true;
+}
+
+bool FTS_RegionStore::SaveChunk(const FIntVector& ChunkID, const FTS_ChunkVoxelStorage* Storage, int32 UniformMaterialID)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TerraScape_Save);
+	TRACE_CPUPROFILER_EVENT_SCOPE(FTS_RegionStore::SaveChunk);
+
+	TArray<uint8> Payload;
+	FMemoryWriter Writer(Payload);
+
+	// Saving only reads the storage
+	FTS_ChunkVoxelStorage EmptyStorage;
+	bool bIsUniform = Storage == nullptr;
+	SerializeChunk(Writer, Storage ? const_cast<FTS_ChunkVoxelStorage&>(*Storage) : EmptyStorage, bIsUniform, UniformMaterialID);
+
+	TSharedPtr<FTS_RegionFile, ESPMode::ThreadSafe> RegionFile = GetRegionFile(FTS_RegionFile::GetRegionID(ChunkID), true);
+	return RegionFile.IsValid() && RegionFile->WriteChunk(FTS_RegionFile::GetLocalIndex(ChunkID), Payload);
+}
+
+uint32 FTS_RegionStore::SaveChunkAsync(const FIntVector& ChunkID, TSharedPtr<const FTS_ChunkVoxelStorage, ESPMode::ThreadSafe> Storage,
+	int32 UniformMaterialID, FQueuedThreadPool* ThreadPool)
+{
+	uint32 Serial;
+	{
+		FScopeLock PendingScope(&PendingSavesLock);
+		FPendingSave* Pending = PendingSaves.Find(ChunkID);
+		const bool bTaskQueued = Pending != nullptr;
+		if (!Pending)
+		{
+			Pending = &PendingSaves.Add(ChunkID);
+		}
+		Pending->Storage = MoveTemp(Storage);
+		Pending->UniformMaterialID = UniformMaterialID;
+		Pending->Serial = Serial = NextSaveSerial++;
+
+		// One task per chunk at a time: the queued one writes whatever is newest when it gets there
+		if (bTaskQueued)
+		{
+			return Serial;
+		}
+
+		if (NumPendingSaves++ == 0)
+		{
+			SavesDoneEvent->Reset();
+		}
+	}
+
+	(new FAutoDeleteAsyncTask<FTS_AsyncChunkSaveTask>(this, ChunkID))->StartBackgroundTask(ThreadPool ? ThreadPool : GThreadPool);
+	return Serial;
+}
+
+void FTS_RegionStore::WaitForPendingSaves()
+{
+	SavesDoneEvent->Wait();
+
+	// The task that triggered the event still holds PendingSavesLock; once it lets go it never touches the store again
+	{
+		FScopeLock PendingScope(&PendingSavesLock);
+	}
+
+	FScopeLock RegionsScope(&RegionsLock);
+	for (auto& RegionPair : Regions)
+	{
+		if (RegionPair.Value.File.IsValid())
+		{
+			RegionPair.Value.File->Flush();
+		}
+	}
+}
+
+FString FTS_RegionStore::GetRegionFilename(const FIntVector& RegionID) const
+{
+	return FPaths::Combine(Directory, FString::Printf(TEXT("r.%d.%d.%d.tsr"), RegionID.X, RegionID.Y, RegionID.Z));
+}
+
+TSharedPtr<FTS_RegionFile, ESPMode::ThreadSafe> FTS_RegionStore::GetRegionFile(const FIntVector& RegionID, bool bCreate)
+{
+	FScopeLock RegionsScope(&RegionsLock);
+	if (FRegionSlot* Existing = Regions.Find(RegionID))
+	{
+		// A region read as missing or stale gets its file (re)created by the first save
+		if (Existing->File.IsValid() || !bCreate || Existing->bCreateFailed)
+		{
+			Existing->LastUse = NextRegionUse++;
+			return Existing->File;
+		}
+	}
+
+	// Missing regions are remembered as null so loads don't hit the file system again
+	TSharedPtr<FTS_RegionFile, ESPMode::ThreadSafe> RegionFile = MakeShared<FTS_RegionFile, ESPMode::ThreadSafe>();
+	if (!RegionFile->Open(GetRegionFilename(RegionID), ChunkSize, GeneratorFingerprint, CompressionFormat, bCreate))
+	{
+		RegionFile.Reset();
+	}
+
+	FRegionSlot& Slot = Regions.FindOrAdd(RegionID);
+	Slot.File = RegionFile;
+	Slot.bCreateFailed = bCreate && !RegionFile.IsValid();
+	Slot.LastUse = NextRegionUse++;
+
+	if (Regions.Num() > MaxOpenRegions)
+	{
+		EvictRegions();
+	}
+	return RegionFile;
+}
+
+void FTS_RegionStore::EvictRegions()
+{
+	// A region a load or save still holds stays open: a second FTS_RegionFile would write the same file.
+	// References are only handed out under RegionsLock, so one that is unique here stays unique.
+	TArray<TPair<uint64, FIntVector>> Candidates;
+	for (const auto& RegionPair : Regions)
+	{
+		const FRegionSlot& Slot = RegionPair.Value;
+		if (!Slot.File.IsValid() || Slot.File.GetSharedReferenceCount() == 1)
+		{
+			Candidates.Emplace(Slot.LastUse, RegionPair.Key);
+		}
+	}
+	Candidates.Sort([](const TPair<uint64, FIntVector>& A, const TPair<uint64, FIntVector>& B)
+	{
+		return A.Key < B.Key;
+	});
+
+	// Evict a batch so the next few regions don't each pay for the sort
+	const int32 NumToEvict = FMath::Min(Candidates.Num(), Regions.Num() - (MaxOpenRegions - MaxOpenRegions / 4));
+	for (int32 Index = 0; Index < NumToEvict; Index++)
+	{
+		// Closing flushes the file
+		Regions.Remove(Candidates[Index].Value);
+	}
+}
+
+void FTS_RegionStore::CompletePendingSave(const FIntVector& ChunkID)
+{
+	for (;;)
+	{
+		FPendingSave Save;
+		{
+			FScopeLock PendingScope(&PendingSavesLock);
+			Save = PendingSaves.FindChecked(ChunkID);
+		}
+
+		const bool bSaved = SaveChunk(ChunkID, Save.Storage.Get(), Save.UniformMaterialID);
+		if (!bSaved)
+		{
+			UE_LOG(LogTerraScape, Warning, TEXT("TerraScape: Could not save chunk %s"), *ChunkID.ToString());
+		}
+
+		// Saved again while this one was being written: write the newer version too
+		FScopeLock PendingScope(&PendingSavesLock);
+		if (PendingSaves.FindChecked(ChunkID).Serial == Save.Serial)
+		{
+			SaveResults.Enqueue(FTS_ChunkSaveResult{ ChunkID, Save.Serial, bSaved });
+
+			// Loads keep getting a failed save until a later one reaches the disk
+			if (bSaved)
+			{
+				FailedSaves.Remove(ChunkID);
+			}
+			else
+			{
+				FailedSaves.Add(ChunkID, MoveTemp(Save));
+			}
+
+			PendingSaves.Remove(ChunkID);
+			if (--NumPendingSaves == 0)
+			{
+				SavesDoneEvent->Trigger();
+			}
+			break;
+		}
+	}
+}
+
+void FTS_RegionStore::SerializeChunk(FArchive& Ar, FTS_ChunkVoxelStorage& Storage, bool& bIsUniform, int32& UniformMaterialID)
+{
+	uint8 UniformFlag = bIsUniform ? 1 : 0;
+	Ar << UniformFlag;
+	bIsUniform = UniformFlag != 0;
+
+	if (bIsUniform)
+	{
+		Ar << UniformMaterialID;
+	}
+	else
+	{
+		Storage.Serialize(Ar);
+	}
+}
@@ -0,0 +1,300 @@
+/**
+ * @file TS_RegionFile.h
+ * @brief Region files storing compressed chunk voxel data on disk
+ * @author Keves
+ * @version 1.0
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Misc/ScopeRWLock.h"
+#include "Templates/UniquePtr.h"
+#include <atomic>
+#include "TS_ChunkStorage.h"
+
+class FEvent;
+class IFileHandle;
+class IMappedFileHandle;
+class IMappedFileRegion;
+class FQueuedThreadPool;
+
+/**
+ * @brief One file holding up to 16x16x16 chunks
+ * Layout: a 32-byte header followed by records, each a 16-byte record header (chunk, sizes and CRC)
+ * and a compressed chunk payload. Writes only ever append a record, so the file is never patched in
+ * place and no seek is needed; opening replays the records and the last one of each chunk wins.
+ * A write cut short leaves an incomplete record at the end, which is dropped on open (the chunk keeps
+ * its previous version) and truncated away before the next append.
+ * Reads decompress straight out of a read-only memory mapping of the file.
+ *
+ * Superseded payloads stay in the file as dead space; nothing compacts them yet.
+ * Thread-safe: any number of readers and one writer at a time.
+ */
+class TERRA_SCAPE_API FTS_RegionFile
+{
+public:
+	/** Chunks per region axis, as a shift */
+	static constexpr int32 RegionShift = 4;
+	static constexpr int32 RegionSize = 1 << RegionShift;
+	static constexpr int32 ChunksPerRegion = RegionSize * RegionSize * RegionSize;
+
+	FTS_RegionFile() = default;
+	~FTS_RegionFile();
+
+	FTS_RegionFile(const FTS_RegionFile&) = delete;
+	FTS_RegionFile& operator=(const FTS_RegionFile&) = delete;
+
+	/**
+	 * Open a region file, creating an empty one if bCreate is set
+	 * A file written for another chunk size or fingerprint is moved to "<Filename>.stale" when creating,
+	 * and a fresh one takes its place.
+	 * @param InCompressionFormat - Codec for new files (NAME_LZ4, NAME_Oodle, ...); existing files keep theirs
+	 * @param InGeneratorFingerprint - Identifies the generator settings and chunk layout the chunks were made with
+	 * @return False if the file is missing or stale (and not created), unreadable, or couldn't be created
+	 */
+	bool Open(const FString& InFilename, int32 InChunkSize, uint32 InGeneratorFingerprint, FName InCompressionFormat, bool bCreate);
+
+	/** Flush and close every handle */
+	void Close();
+
+	/** Whether a chunk of the region has stored data */
+	bool HasChunk(int32 LocalIndex) const;
+
+	/**
+	 * Decompress a chunk's payload
+	 * @return False if the chunk isn't stored or its data is corrupt
+	 */
+	bool ReadChunk(int32 LocalIndex, TArray<uint8>& OutData);
+
+	/** Compress a chunk's payload and append it, replacing any stored version (blocking) */
+	bool WriteChunk(int32 LocalIndex, TArrayView<const uint8> Data);
+
+	/** Push appended data to disk */
+	void Flush();
+
+	/** Region containing a chunk */
+	static FORCEINLINE FIntVector GetRegionID(const FIntVector& ChunkID)
+	{
+		// Arithmetic shift floors, so negative chunks land in negative regions
+		return FIntVector(ChunkID.X >> RegionShift, ChunkID.Y >> RegionShift, ChunkID.Z >> RegionShift);
+	}
+
+	/** Index of a chunk within its region */
+	static FORCEINLINE int32 GetLocalIndex(const FIntVector& ChunkID)
+	{
+		const int32 Mask = RegionSize - 1;
+		return (ChunkID.X & Mask) + ((ChunkID.Y & Mask) << RegionShift) + ((ChunkID.Z & Mask) << (RegionShift * 2));
+	}
+
+private:
+	struct FHeader
+	{
+		uint32 Magic = 0;
+		uint32 Version = 0;
+		int32 ChunkSize = 0;
+
+		/** Codec of every payload in the file */
+		uint32 CompressionFormat = 0;
+
+		/** UTS_ChunkManager::GetGeneratorFingerprint of the world the chunks belong to */
+		uint32 GeneratorFingerprint = 0;
+		uint32 Reserved[3] = {};
+	};
+
+	/** Precedes every payload in the file */
+	struct FRecordHeader
+	{
+		uint32 LocalIndex = 0;
+		uint32 CompressedSize = 0;
+		uint32 UncompressedSize = 0;
+
+		/** CRC32 of the compressed payload */
+		uint32 Crc = 0;
+	};
+
+	static_assert(sizeof(FHeader) == 32 && sizeof(FRecordHeader) == 16, "Region file layout changed");
+
+	/** Where a chunk's latest payload lives; CompressedSize 0 means not stored */
+	struct FEntry
+	{
+		uint64 Offset = 0;
+		uint32 CompressedSize = 0;
+		uint32 UncompressedSize = 0;
+		uint32 Crc = 0;
+	};
+
+	static constexpr uint32 FileMagic = 0x47525354; // 'TSRG'
+	static constexpr uint32 FileVersion = 3;
+
+	FString Filename;
+	FName CompressionFormat;
+	TArray<FEntry> Entries;
+
+	/** End of the last complete record, where the next one goes */
+	int64 FileSize = 0;
+
+	/** Read-only view of the file as it was when last mapped */
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	int64 MappedSize = 0;
+
+	/** Opened for append on the first write */
+	TUniquePtr<IFileHandle> WriteHandle;
+
+	/** Guards Entries and the mapping; writers hold it exclusively only to publish an entry or remap */
+	mutable FRWLock EntriesLock;
+
+	/** Serializes writers */
+	FCriticalSection WriteLock;
+
+	/** Map the whole file again so payloads appended since are covered (EntriesLock held exclusively) */
+	bool Remap();
+
+	/** Rename a stale file to "<Filename>.stale", replacing an older one */
+	bool MoveAside();
+
+	/** Fill Entries from the records and cut FileSize back to the last complete one (EntriesLock held exclusively) */
+	bool ReadRecords();
+
+	/** Read a payload through a plain file handle when the file can't be mapped */
+	bool ReadUnmapped(const FEntry& Entry, TArray<uint8>& OutCompressed) const;
+
+	/** Check a payload's CRC and expand it with the file's codec */
+	bool Decompress(const uint8* Compressed, const FEntry& Entry, TArray<uint8>& OutData) const;
+
+	static uint32 GetFormatID(FName Format);
+	static FName GetFormatName(uint32 FormatID);
+};
+
+/**
+ * @brief Outcome of an async chunk save, reported back to whoever queued it
+ * Serial is the one SaveChunkAsync returned for the version that was written.
+ */
+struct FTS_ChunkSaveResult
+{
+	FIntVector ChunkID;
+	uint32 Serial = 0;
+	bool bSucceeded = false;
+};
+
+/**
+ * @brief Every region file of one saved world, loaded on demand
+ * Saves run asynchronously; until a save has reached its region file, loading that chunk returns
+ * the data being saved, so a chunk unloaded and reloaded in quick succession never reads stale data.
+ * A save that fails is kept in memory the same way until a later save of the chunk succeeds.
+ * At most MaxOpenRegions regions are kept open; the least recently used ones that no load or save is
+ * using are closed when more are opened.
+ * Save tasks don't keep the store alive; destroying it waits for them instead.
+ */
+class TERRA_SCAPE_API FTS_RegionStore
+{
+public:
+	/**
+	 * @param InDirectory - Folder of the world's region files, created on the first save
+	 * @param InGeneratorFingerprint - Written into new region files; files with another one are moved aside by the first save
+	 * @param InCompressionFormat - Codec for new region files (NAME_LZ4 favours load speed, NAME_Oodle size)
+	 */
+	FTS_RegionStore(const FString& InDirectory, int32 InChunkSize, uint32 InGeneratorFingerprint, FName InCompressionFormat);
+	~FTS_RegionStore();
+
+	/**
+	 * Load a stored chunk (any thread)
+	 * Mips aren't stored, rebuild them on OutStorage; it's left empty when the chunk is uniform.
+	 * @param bOutUnsaved - Set when the data hasn't reached its region file, because the save is queued or failed
+	 * @return False if the chunk was never saved or its data is unreadable
+	 */
+	bool LoadChunk(const FIntVector& ChunkID, FTS_ChunkVoxelStorage& OutStorage, bool& bOutIsUniform, int32& OutUniformMaterialID,
+		bool* bOutUnsaved = nullptr);
+
+	/**
+	 * Save a chunk and wait for it (any thread)
+	 * @param Storage - The chunk's voxels, nullptr for a uniform chunk of UniformMaterialID
+	 */
+	bool SaveChunk(const FIntVector& ChunkID, const FTS_ChunkVoxelStorage* Storage, int32 UniformMaterialID);
+
+	/**
+	 * Save a chunk on a worker thread; the snapshot is shared, not copied
+	 * @return Serial of the save, reported with its FTS_ChunkSaveResult
+	 */
+	uint32 SaveChunkAsync(const FIntVector& ChunkID, TSharedPtr<const FTS_ChunkVoxelStorage, ESPMode::ThreadSafe> Storage,
+		int32 UniformMaterialID, FQueuedThreadPool* ThreadPool);
+
+	/** Block until every async save has been written and its task is done with the store, then flush the region files */
+	void WaitForPendingSaves();
+
+	/** Take the next finished async save (any thread, one consumer); false once there are none */
+	FORCEINLINE bool DequeueSaveResult(FTS_ChunkSaveResult& OutResult) { return SaveResults.Dequeue(OutResult); }
+
+	FORCEINLINE int32 GetNumPendingSaves() const { return NumPendingSaves.load(); }
+	FORCEINLINE const FString& GetDirectory() const { return Directory; }
+
+	/** Path of a region's file */
+	FString GetRegionFilename(const FIntVector& RegionID) const;
+
+private:
+	friend class FTS_AsyncChunkSaveTask;
+
+	/** A save that hasn't reached its region file yet; Serial changes whenever it's replaced */
+	struct FPendingSave
+	{
+		TSharedPtr<const FTS_ChunkVoxelStorage, ESPMode::ThreadSafe> Storage;
+		int32 UniformMaterialID = 0;
+		uint32 Serial = 0;
+	};
+
+	FString Directory;
+	int32 ChunkSize;
+	uint32 GeneratorFingerprint;
+	FName CompressionFormat;
+
+	/** An open region; File is null for a region known to have no usable file */
+	struct FRegionSlot
+	{
+		TSharedPtr<FTS_RegionFile, ESPMode::ThreadSafe> File;
+
+		/** Creating the file failed; saves to the region fail right away instead of retrying it */
+		bool bCreateFailed = false;
+
+		/** NextRegionUse when the region was last looked up */
+		uint64 LastUse = 0;
+	};
+
+	/** Regions kept before the least recently used are closed (null entries count too) */
+	static constexpr int32 MaxOpenRegions = 64;
+
+	/** Open regions by region ID */
+	TMap<FIntVector, FRegionSlot> Regions;
+	FCriticalSection RegionsLock;
+	uint64 NextRegionUse = 0;
+
+	/** Latest queued save per chunk */
+	TMap<FIntVector, FPendingSave> PendingSaves;
+
+	/** Latest save per chunk that couldn't be written, until one is (PendingSavesLock) */
+	TMap<FIntVector, FPendingSave> FailedSaves;
+	FCriticalSection PendingSavesLock;
+	uint32 NextSaveSerial = 1;
+
+	/** Save tasks queued or running; changed under PendingSavesLock, read without it for stats */
+	std::atomic<int32> NumPendingSaves{ 0 };
+
+	/** Triggered while NumPendingSaves is 0 (manual reset) */
+	FEvent* SavesDoneEvent = nullptr;
+
+	/** Finished async saves, pushed by the workers */
+	TQueue<FTS_ChunkSaveResult, EQueueMode::Mpsc> SaveResults;
+
+	/** Open region file of a region, opening or creating it on first use */
+	TSharedPtr<FTS_RegionFile, ESPMode::ThreadSafe> GetRegionFile(const FIntVector& RegionID, bool bCreate);
+
+	/** Close the least recently used regions nobody else holds until a quarter of MaxOpenRegions is free (RegionsLock held) */
+	void EvictRegions();
+
+	/** Write a chunk's queued save, again if it was replaced meanwhile, then report it and drop it (worker thread) */
+	void CompletePendingSave(const FIntVector& ChunkID);
+
+	/** Chunk payload: a uniform flag and material, or the serialized storage */
+	static void SerializeChunk(FArchive& Ar, FTS_ChunkVoxelStorage& Storage, bool& bIsUniform, int32& UniformMaterialID);
+};
@@ -0,0 +1,200 @@
+/**
+ * @file TS_RegionFileTests.cpp
+ * @brief Automation tests for TerraScape region files
+ * @author Keves
+ * @version 1.0
+ */
+
+#include "TS_RegionFile.h"
+#include "HAL/PlatformFileManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTS_RegionFileRoundTripTest, "TerraScape.RegionFile.RoundTrip",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * Writes chunks, closes and reopens the file and reads them back; then appends to the existing file,
+ * including after a record cut short by a crash, and replaces it once the world generation settings change
+ */
+bool FTS_RegionFileRoundTripTest::RunTest(const FString& Parameters)
+{
+	const int32 ChunkSize = 32;
+	const uint32 Fingerprint = 0x5EED1337;
+	const FString Filename = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("TerraScape"), TEXT("r.0.0.0.tsr"));
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.DeleteFile(*Filename);
+
+	// Few distinct values, so the payloads compress like voxel data does
+	auto MakePayload = [](int32 Seed, int32 Num)
+	{
+		FRandomStream Random(Seed);
+		TArray<uint8> Payload;
+		Payload.SetNumUninitialized(Num);
+		for (uint8& Byte : Payload)
+		{
+			Byte = static_cast<uint8>(Random.RandRange(0, 7));
+		}
+		return Payload;
+	};
+	const TArray<uint8> First = MakePayload(1, 4000);
+	const TArray<uint8> Second = MakePayload(2, 1500);
+	const TArray<uint8> Replaced = MakePayload(3, 6000);
+	const TArray<uint8> Third = MakePayload(4, 2500);
+
+	auto TestChunk = [this](FTS_RegionFile& File, int32 LocalIndex, const TArray<uint8>& Expected, const TCHAR* Stage)
+	{
+		TArray<uint8> Data;
+		TestTrue(FString::Printf(TEXT("%s: chunk %d reads back"), Stage, LocalIndex), File.ReadChunk(LocalIndex, Data) && Data == Expected);
+	};
+
+	{
+		FTS_RegionFile File;
+		if (!TestTrue(TEXT("Region file is created"), File.Open(Filename, ChunkSize, Fingerprint, NAME_LZ4, true)))
+		{
+			return false;
+		}
+		TestTrue(TEXT("Chunks are written to a new file"),
+			File.WriteChunk(0, First) && File.WriteChunk(5, Second) && File.WriteChunk(0, Replaced));
+		TestChunk(File, 0, Replaced, TEXT("Before closing"));
+		File.Close();
+	}
+
+	// The last write of a chunk wins, and appending keeps what the file already holds
+	{
+		FTS_RegionFile File;
+		if (!TestTrue(TEXT("Region file is reopened"), File.Open(Filename, ChunkSize, Fingerprint, NAME_LZ4, false)))
+		{
+			return false;
+		}
+		TestChunk(File, 0, Replaced, TEXT("Reopened"));
+		TestChunk(File, 5, Second, TEXT("Reopened"));
+		TestFalse(TEXT("Reopened: chunk 1 was never written"), File.HasChunk(1));
+		TestTrue(TEXT("A chunk is appended to the existing file"), File.WriteChunk(7, Third));
+		File.Close();
+	}
+
+	// A crash halfway through a write: a record header (same layout as FRecordHeader) with part of its payload
+	{
+		const uint32 TornRecord[4] = { 9, 1000, 1000, 0 };
+		TUniquePtr<IFileHandle> Handle(PlatformFile.OpenWrite(*Filename, true, false));
+		TestTrue(TEXT("Torn record is appended"), Handle
+			&& Handle->Write(reinterpret_cast<const uint8*>(TornRecord), sizeof(TornRecord))
+			&& Handle->Write(First.GetData(), 100));
+	}
+
+	AddExpectedMessage(TEXT("ends in an incomplete record"), ELogVerbosity::Warning, EAutomationExpectedMessageFlags::Contains, 1);
+	{
+		FTS_RegionFile File;
+		if (!TestTrue(TEXT("Region file with a torn record is reopened"), File.Open(Filename, ChunkSize, Fingerprint, NAME_LZ4, false)))
+		{
+			return false;
+		}
+		TestChunk(File, 0, Replaced, TEXT("After the torn record"));
+		TestChunk(File, 5, Second, TEXT("After the torn record"));
+		TestChunk(File, 7, Third, TEXT("After the torn record"));
+		TestFalse(TEXT("After the torn record: chunk 9 isn't stored"), File.HasChunk(9));
+		TestTrue(TEXT("A chunk is appended after the torn record"), File.WriteChunk(9, Second));
+		File.Close();
+	}
+
+	{
+		FTS_RegionFile File;
+		if (!TestTrue(TEXT("Region file is reopened after truncation"), File.Open(Filename, ChunkSize, Fingerprint, NAME_LZ4, false)))
+		{
+			return false;
+		}
+		TestChunk(File, 0, Replaced, TEXT("After truncation"));
+		TestChunk(File, 7, Third, TEXT("After truncation"));
+		TestChunk(File, 9, Second, TEXT("After truncation"));
+		File.Close();
+	}
+
+	// Made for another world: rejected like a chunk size mismatch, and moved aside when saving into the region
+	const FString StaleFilename = Filename + TEXT(".stale");
+	PlatformFile.DeleteFile(*StaleFilename);
+	AddExpectedMessage(TEXT("made with other world generation settings"), ELogVerbosity::Warning, EAutomationExpectedMessageFlags::Contains, 2);
+	AddExpectedMessage(TEXT("Moved stale region file"), ELogVerbosity::Warning, EAutomationExpectedMessageFlags::Contains, 1);
+	{
+		FTS_RegionFile File;
+		TestFalse(TEXT("Region file with another generator fingerprint is rejected"),
+			File.Open(Filename, ChunkSize, Fingerprint + 1, NAME_LZ4, false));
+		TestTrue(TEXT("Region file with another generator fingerprint is replaced when creating"),
+			File.Open(Filename, ChunkSize, Fingerprint + 1, NAME_LZ4, true));
+		TestTrue(TEXT("Stale region file is kept"), PlatformFile.FileExists(*StaleFilename));
+		TestFalse(TEXT("Replaced region file starts empty"), File.HasChunk(0));
+		TestTrue(TEXT("A chunk is written to the replaced region file"), File.WriteChunk(0, First));
+		TestChunk(File, 0, First, TEXT("Replaced"));
+		File.Close();
+	}
+
+	PlatformFile.DeleteFile(*Filename);
+	PlatformFile.DeleteFile(*StaleFilename);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTS_RegionStoreFailedSaveTest, "TerraScape.RegionFile.FailedSave",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * Saves into a world folder that can't be created: the failure is reported, and the chunk still loads
+ * with the data that wasn't written
+ */
+bool FTS_RegionStoreFailedSaveTest::RunTest(const FString& Parameters)
+{
+	const FIntVector ChunkID(3, -2, 1);
+	const int32 MaterialID = 4;
+
+	// A file where the world folder should be
+	const FString Blocker = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("TerraScape"), TEXT("NotAFolder"));
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Blocker));
+	{
+		TUniquePtr<IFileHandle> Handle(PlatformFile.OpenWrite(*Blocker));
+		if (!TestTrue(TEXT("Blocking file is created"), Handle.IsValid()))
+		{
+			return false;
+		}
+	}
+
+	AddExpectedMessage(TEXT("Could not create region file"), ELogVerbosity::Warning, EAutomationExpectedMessageFlags::Contains, 1);
+	AddExpectedMessage(TEXT("Could not save chunk"), ELogVerbosity::Warning, EAutomationExpectedMessageFlags::Contains, 2);
+	AddExpectedMessage(TEXT("could not be saved"), ELogVerbosity::Error, EAutomationExpectedMessageFlags::Contains, 1);
+	{
+		TSharedRef<FTS_RegionStore, ESPMode::ThreadSafe> Store = MakeShared<FTS_RegionStore, ESPMode::ThreadSafe>(
+			Blocker, 32, 0x5EED1337, NAME_LZ4);
+
+		const uint32 Serial = Store->SaveChunkAsync(ChunkID, nullptr, MaterialID, nullptr);
+		Store->WaitForPendingSaves();
+
+		FTS_ChunkSaveResult Result;
+		TestTrue(TEXT("The save reports back"), Store->DequeueSaveResult(Result));
+		TestTrue(TEXT("The report is for the queued save"), Result.ChunkID == ChunkID && Result.Serial == Serial);
+		TestFalse(TEXT("The save is reported as failed"), Result.bSucceeded);
+
+		FTS_ChunkVoxelStorage Storage;
+		bool bIsUniform = false;
+		bool bUnsaved = false;
+		int32 UniformMaterialID = 0;
+		TestTrue(TEXT("The chunk still loads after the failed save"),
+			Store->LoadChunk(ChunkID, Storage, bIsUniform, UniformMaterialID, &bUnsaved));
+		TestTrue(TEXT("The loaded chunk is the one that failed to save"), bIsUniform && UniformMaterialID == MaterialID);
+		TestTrue(TEXT("The loaded chunk is flagged as unsaved"), bUnsaved);
+
+		// The region isn't created again, the next save fails right away
+		Store->SaveChunkAsync(ChunkID, nullptr, MaterialID, nullptr);
+		Store->WaitForPendingSaves();
+		TestTrue(TEXT("The second save reports back"), Store->DequeueSaveResult(Result) && !Result.bSucceeded);
+
+		// The store is released here, on this thread, and logs the lost save before the test ends
+		TestTrue(TEXT("No save task holds the store after waiting"), Store.IsUnique());
+	}
+
+	PlatformFile.DeleteFile(*Blocker);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
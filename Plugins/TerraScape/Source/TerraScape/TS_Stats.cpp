@@ -0,0 +1,31 @@
+/**
+ * @file TS_Stats.cpp
+ * @brief Log category and stats group for TerraScape
+ * @author Keves
+ * @version 1.0
+ */
+
+#include "TS_Stats.h"
+
+DEFINE_LOG_CATEGORY(LogTerraScape);
+
+DEFINE_STAT(STAT_TerraScape_Generation);
+DEFINE_STAT(STAT_TerraScape_Meshing);
+DEFINE_STAT(STAT_TerraScape_Upload);
+DEFINE_STAT(STAT_TerraScape_Collision);
+DEFINE_STAT(STAT_TerraScape_Save);
+DEFINE_STAT(STAT_TerraScape_Tick);
+
+DEFINE_STAT(STAT_TerraScape_VoxelMemory);
+DEFINE_STAT(STAT_TerraScape_MeshMemory);
+
+DEFINE_STAT(STAT_TerraScape_LoadedChunks);
+DEFINE_STAT(STAT_TerraScape_MeshedChunks);
+DEFINE_STAT(STAT_TerraScape_GenerationQueue);
+DEFINE_STAT(STAT_TerraScape_MeshQueue);
+DEFINE_STAT(STAT_TerraScape_UploadQueue);
+DEFINE_STAT(STAT_TerraScape_GenerationTasks);
+DEFINE_STAT(STAT_TerraScape_MeshTasks);
+DEFINE_STAT(STAT_TerraScape_PendingSaves);
+
+DEFINE_STAT(STAT_TerraScape_ChunkLatency);
@@ -0,0 +1,49 @@
+/**
+ * @file TS_Stats.h
+ * @brief Log category and stats group for TerraScape
+ * @author Keves
+ * @version 1.0
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/**
+ * TerraScape log category
+ * Per-chunk messages are Verbose or VeryVerbose and are compiled out of shipping builds;
+ * enable them with "log LogTerraScape Verbose".
+ */
+#if UE_BUILD_SHIPPING
+TERRA_SCAPE_API DECLARE_LOG_CATEGORY_EXTERN(LogTerraScape, Log, Log);
+#else
+TERRA_SCAPE_API DECLARE_LOG_CATEGORY_EXTERN(LogTerraScape, Log, All);
+#endif
+
+/** "stat TerraScape": pipeline timings, memory, queue depths and chunk latency */
+DECLARE_STATS_GROUP(TEXT("TerraScape"), STATGROUP_TerraScape, STATCAT_Advanced);
+
+/** Stage timings; generation and meshing run on workers, the rest on the game thread */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Voxel Generation"), STAT_TerraScape_Generation, STATGROUP_TerraScape, TERRA_SCAPE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Meshing"), STAT_TerraScape_Meshing, STATGROUP_TerraScape, TERRA_SCAPE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Mesh Upload"), STAT_TerraScape_Upload, STATGROUP_TerraScape, TERRA_SCAPE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Collision"), STAT_TerraScape_Collision, STATGROUP_TerraScape, TERRA_SCAPE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Chunk Save"), STAT_TerraScape_Save, STATGROUP_TerraScape, TERRA_SCAPE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Chunk Manager Tick"), STAT_TerraScape_Tick, STATGROUP_TerraScape, TERRA_SCAPE_API);
+
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Voxel Memory"), STAT_TerraScape_VoxelMemory, STATGROUP_TerraScape, TERRA_SCAPE_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Mesh Memory"), STAT_TerraScape_MeshMemory, STATGROUP_TerraScape, TERRA_SCAPE_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Loaded Chunks"), STAT_TerraScape_LoadedChunks, STATGROUP_TerraScape, TERRA_SCAPE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Meshed Chunks"), STAT_TerraScape_MeshedChunks, STATGROUP_TerraScape, TERRA_SCAPE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Generation Queue"), STAT_TerraScape_GenerationQueue, STATGROUP_TerraScape, TERRA_SCAPE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Mesh Queue"), STAT_TerraScape_MeshQueue, STATGROUP_TerraScape, TERRA_SCAPE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Upload Queue"), STAT_TerraScape_UploadQueue, STATGROUP_TerraScape, TERRA_SCAPE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Generation Tasks In Flight"), STAT_TerraScape_GenerationTasks, STATGROUP_TerraScape, TERRA_SCAPE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Mesh Tasks In Flight"), STAT_TerraScape_MeshTasks, STATGROUP_TerraScape, TERRA_SCAPE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pending Saves"), STAT_TerraScape_PendingSaves, STATGROUP_TerraScape, TERRA_SCAPE_API);
+
+/** Time from creating a chunk to uploading its first mesh, for the last chunk that got one */
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Chunk Latency (ms)"), STAT_TerraScape_ChunkLatency, STATGROUP_TerraScape, TERRA_SCAPE_API);
@@ -6,6 +6,7 @@
  */
 
 #include "TS_TerraScapeManager.h"
+#include "TS_Stats.h"
 #include "Components/SceneComponent.h"
 
 ATS_TerraScapeManager::ATS_TerraScapeManager()
@@ -24,7 +25,7 @@ void ATS_TerraScapeManager::BeginPlay()
 {
 	Super::BeginPlay();
 	
-	UE_LOG(LogTemp, Log, TEXT("TerraScape Manager started - MVP version"));
+	UE_LOG(LogTerraScape, Log, TEXT("TerraScape Manager started - MVP version"));
 }
 
 void ATS_TerraScapeManager::CreateTestChunk(const FIntVector& ChunkID)
@@ -48,31 +48,22 @@ public:
 };
 
 /**
- * @brief Basic chunk data structure for MVP
+ * @brief Face order shared by meshing, aprons and neighbour links: +X, -X, +Y, -Y, +Z, -Z
+ * The face opposite FaceIndex is FaceIndex ^ 1.
  */
-USTRUCT(BlueprintType)
-struct FTS_Chunk
+struct FTS_ChunkFaces
 {
-	GENERATED_BODY()
-
-public:
-	/** Chunk ID in world space */
-	UPROPERTY(BlueprintReadOnly, Category = "TerraScape | Voxel")
-	FIntVector ChunkID;
-
-	/** World position of this chunk */
-	UPROPERTY(BlueprintReadOnly, Category = "TerraScape | Voxel")
-	FVector WorldPosition;
-
-	/** Whether this chunk is loaded */
-	UPROPERTY(BlueprintReadOnly, Category = "TerraScape | Voxel")
-	bool bIsLoaded = false;
-
-	FTS_Chunk()
-		: ChunkID(FIntVector::ZeroValue)
-		, WorldPosition(FVector::ZeroVector)
-		, bIsLoaded(false)
+	/** Unit step from a chunk to its neighbour across a face */
+	static FIntVector GetDirection(int32 FaceIndex)
 	{
+		static const FIntVector Directions[6] = {
+			FIntVector(1, 0, 0),   // Right
+			FIntVector(-1, 0, 0),  // Left
+			FIntVector(0, 1, 0),   // Forward
+			FIntVector(0, -1, 0),  // Back
+			FIntVector(0, 0, 1),   // Up
+			FIntVector(0, 0, -1)   // Down
+		};
+		return Directions[FaceIndex];
 	}
 };
-
@@ -0,0 +1,65 @@
+/**
+ * @file TS_WorkerPool.cpp
+ * @brief Thread pool reserved for TerraScape chunk work
+ * @author Keves
+ * @version 1.0
+ */
+
+#include "TS_WorkerPool.h"
+#include "TS_Stats.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformProcess.h"
+
+/** Noise evaluation and meshing keep their scratch data on the heap, this leaves room for deep call chains */
+static constexpr uint32 WorkerStackSize = 128 * 1024;
+
+FTS_WorkerPool::~FTS_WorkerPool()
+{
+	Stop();
+}
+
+bool FTS_WorkerPool::Start(int32 InNumThreads, EThreadPriority Priority, uint64 InAffinityMask)
+{
+	Stop();
+
+	NumThreads = InNumThreads > 0 ? InNumThreads : GetDefaultNumThreads();
+	AffinityMask = InAffinityMask;
+
+	Pool.Reset(FQueuedThreadPool::Allocate());
+	if (!Pool->Create(NumThreads, WorkerStackSize, Priority, TEXT("TerraScapeWorkerPool")))
+	{
+		UE_LOG(LogTerraScape, Error, TEXT("TerraScape: Failed to create %d worker threads"), NumThreads);
+		Pool.Reset();
+		NumThreads = 0;
+		return false;
+	}
+
+	UE_LOG(LogTerraScape, Log, TEXT("TerraScape: Started %d worker threads (affinity 0x%llx)"), NumThreads, AffinityMask);
+	return true;
+}
+
+void FTS_WorkerPool::Stop()
+{
+	if (Pool.IsValid())
+	{
+		Pool->Destroy();
+		Pool.Reset();
+		UE_LOG(LogTerraScape, Log, TEXT("TerraScape: Stopped %d worker threads"), NumThreads);
+	}
+	NumThreads = 0;
+}
+
+int32 FTS_WorkerPool::GetDefaultNumThreads()
+{
+	return FMath::Max(1, FPlatformMisc::NumberOfCores());
+}
+
+void FTS_WorkerPool::ApplyAffinityToCurrentThread(uint64 Mask)
+{
+	thread_local uint64 AppliedMask = 0;
+	if (Mask != 0 && Mask != AppliedMask)
+	{
+		FPlatformProcess::SetThreadAffinityMask(Mask);
+		AppliedMask = Mask;
+	}
+}
@@ -0,0 +1,56 @@
+/**
+ * @file TS_WorkerPool.h
+ * @brief Thread pool reserved for TerraScape chunk work
+ * @author Keves
+ * @version 1.0
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/QueuedThreadPool.h"
+
+/**
+ * @brief Worker threads that only run TerraScape generation and meshing tasks
+ * Keeps chunk work from competing with asset streaming and other users of GThreadPool, and lets
+ * the thread count, priority and core affinity be chosen per deployment (e.g. every core of a server).
+ */
+class TERRA_SCAPE_API FTS_WorkerPool
+{
+public:
+	FTS_WorkerPool() = default;
+	~FTS_WorkerPool();
+
+	FTS_WorkerPool(const FTS_WorkerPool&) = delete;
+	FTS_WorkerPool& operator=(const FTS_WorkerPool&) = delete;
+
+	/**
+	 * Create the worker threads, stopping any previous ones first
+	 * @param NumThreads - Worker count, 0 for GetDefaultNumThreads()
+	 * @param AffinityMask - Cores the workers may run on, 0 for any
+	 * @return False if the threads couldn't be created
+	 */
+	bool Start(int32 NumThreads, EThreadPriority Priority, uint64 AffinityMask);
+
+	/** Destroy the threads (queued tasks are run first, so stop or finish them before) */
+	void Stop();
+
+	FORCEINLINE bool IsRunning() const { return Pool.IsValid(); }
+	FORCEINLINE FQueuedThreadPool* GetPool() const { return Pool.Get(); }
+	FORCEINLINE int32 GetNumThreads() const { return NumThreads; }
+	FORCEINLINE uint64 GetAffinityMask() const { return AffinityMask; }
+
+	/** One worker per physical core */
+	static int32 GetDefaultNumThreads();
+
+	/**
+	 * Pin the calling worker thread to a set of cores; called by tasks when they start, the mask is
+	 * only applied once per thread since the pool's threads run nothing else
+	 */
+	static void ApplyAffinityToCurrentThread(uint64 Mask);
+
+private:
+	TUniquePtr<FQueuedThreadPool> Pool;
+	int32 NumThreads = 0;
+	uint64 AffinityMask = 0;
+};
@@ -1,4 +1,5 @@
 #include "TS_WorldGenerator.h"
+#include "TS_Stats.h"
 #include "TS_ProceduralNoise.h"
 #include "TS_BiomeManager.h"
 #include "Math/UnrealMathUtility.h"
@@ -34,35 +35,211 @@ void UTS_WorldGenerator::Initialize()
 
 void UTS_WorldGenerator::GenerateChunkVoxels(int32 ChunkX, int32 ChunkY, int32 ChunkZ, int32 ChunkSize, float VoxelSize, TArray<int32>& OutVoxelData)
 {
-	// Clear output array
+	// Calculate chunk world position
+	const FVector ChunkWorldPos(
+		ChunkX * ChunkSize * VoxelSize,
+		ChunkY * ChunkSize * VoxelSize,
+		ChunkZ * ChunkSize * VoxelSize
+	);
+
+	TArray<FTS_Voxel> VoxelData;
+	int32 UniformMaterialID = 0;
+	if (GenerateChunkVoxelData(ChunkWorldPos, ChunkSize, VoxelSize, VoxelData, UniformMaterialID))
+	{
+		OutVoxelData.Init(UniformMaterialID, ChunkSize * ChunkSize * ChunkSize);
+		return;
+	}
+
+	// Store voxel data (0 = air, >0 = material ID)
 	OutVoxelData.Empty();
+	OutVoxelData.SetNumUninitialized(VoxelData.Num());
+	for (int32 Index = 0; Index < VoxelData.Num(); Index++)
+	{
+		OutVoxelData[Index] = VoxelData[Index].MaterialID;
+	}
+}
+
+bool UTS_WorldGenerator::GenerateChunkVoxelData(const FVector& ChunkWorldPos, int32 ChunkSize, float VoxelSize, TArray<FTS_Voxel>& OutVoxelData, int32& OutUniformMaterialID, 
+	const std::atomic<bool>* bCancelled) const
+{
+	OutVoxelData.Reset();
+	OutUniformMaterialID = 0;
+
+	// Sky and deep chunks outside the terrain bands don't need any noise at all
+	if (IsChunkOutsideTerrainBounds(ChunkWorldPos, ChunkSize, VoxelSize))
+	{
+		return true;
+	}
+
+	// 2D pass: terrain height and biome material once per column
+	FTS_ChunkHeightmap Heightmap;
+	BuildChunkHeightmap(ChunkWorldPos, ChunkSize, VoxelSize, Heightmap);
+
+	const bool bUseBiomeMaterials = Heightmap.SurfaceMaterialIDs.Num() > 0;
+	const bool bUseCaves = NoiseGenerator && WorldGenParameters.bEnableCaves;
+
+	const float BottomZ = ChunkWorldPos.Z;
+	const float TopZ = ChunkWorldPos.Z + ((ChunkSize - 1) * VoxelSize);
+
+	// Entirely above the highest column of this chunk
+	if (BottomZ >= Heightmap.MaxTerrainHeight)
+	{
+		return true;
+	}
+
+	// Entirely below the lowest column: uniform if nothing can carve it and every column has the same material
+	if (TopZ < Heightmap.MinTerrainHeight && !bUseCaves && bUseBiomeMaterials &&
+		BottomZ >= WorldGenParameters.MinHeight && TopZ <= WorldGenParameters.MaxHeight)
+	{
+		const int32 FirstMaterialID = Heightmap.SurfaceMaterialIDs[0];
+		bool bSameMaterial = true;
+		for (int32 MaterialID : Heightmap.SurfaceMaterialIDs)
+		{
+			if (MaterialID != FirstMaterialID)
+			{
+				bSameMaterial = false;
+				break;
+			}
+		}
+
+		if (bSameMaterial)
+		{
+			OutUniformMaterialID = FirstMaterialID;
+			return true;
+		}
+	}
+
 	OutVoxelData.SetNum(ChunkSize * ChunkSize * ChunkSize);
 
-	// Calculate chunk world position
-	float ChunkWorldX = ChunkX * ChunkSize * VoxelSize;
-	float ChunkWorldY = ChunkY * ChunkSize * VoxelSize;
-	float ChunkWorldZ = ChunkZ * ChunkSize * VoxelSize;
+	// 3D pass, one column at a time so cave noise can be batched along Z
+	TArray<float> CaveDensities;
+	CaveDensities.SetNumUninitialized(ChunkSize);
 
-	// Generate voxels for this chunk
-	for (int32 X = 0; X < ChunkSize; X++)
+	for (int32 Y = 0; Y < ChunkSize; Y++)
 	{
-		for (int32 Y = 0; Y < ChunkSize; Y++)
+		if (bCancelled && bCancelled->load(std::memory_order_relaxed))
 		{
-			for (int32 Z = 0; Z < ChunkSize; Z++)
+			return false; // Nobody wants this chunk any more
+		}
+
+		const float WorldY = ChunkWorldPos.Y + (Y * VoxelSize);
+
+		for (int32 X = 0; X < ChunkSize; X++)
+		{
+			const float WorldX = ChunkWorldPos.X + (X * VoxelSize);
+			const int32 ColumnIndex = Heightmap.GetIndex(X, Y);
+			const float TerrainHeight = Heightmap.Heights[ColumnIndex];
+
+			// Everything at or above the surface is air, so only the run below it needs cave noise
+			int32 NumBelowSurface = 0;
+			while (NumBelowSurface < ChunkSize && ChunkWorldPos.Z + (NumBelowSurface * VoxelSize) < TerrainHeight)
+			{
+				NumBelowSurface++;
+			}
+
+			if (NumBelowSurface == 0)
+			{
+				continue;
+			}
+
+			if (bUseCaves)
+			{
+				UTS_ProceduralNoise::GetCaveDensityBatch(
+					FVector(WorldX, WorldY, ChunkWorldPos.Z),
+					FVector(0.0f, 0.0f, VoxelSize),
+					CaveNoiseParams,
+					TArrayView<float>(CaveDensities.GetData(), NumBelowSurface));
+			}
+
+			for (int32 Z = 0; Z < NumBelowSurface; Z++)
 			{
-				// Calculate world coordinates for this voxel
-				float WorldX = ChunkWorldX + (X * VoxelSize);
-				float WorldY = ChunkWorldY + (Y * VoxelSize);
-				float WorldZ = ChunkWorldZ + (Z * VoxelSize);
+				const float WorldZ = ChunkWorldPos.Z + (Z * VoxelSize);
+
+				// Same rules as ShouldVoxelBeSolid
+				if (bUseCaves && CaveDensities[Z] > WorldGenParameters.CaveThreshold)
+				{
+					continue;
+				}
+
+				if (WorldZ < WorldGenParameters.MinHeight || WorldZ > WorldGenParameters.MaxHeight)
+				{
+					continue;
+				}
+
+				const int32 Index = X + (Y * ChunkSize) + (Z * ChunkSize * ChunkSize);
+				OutVoxelData[Index].MaterialID = bUseBiomeMaterials
+					? Heightmap.SurfaceMaterialIDs[ColumnIndex]
+					: GetVoxelMaterialID(WorldX, WorldY, WorldZ, TerrainHeight);
+			}
+		}
+	}
+
+	return false;
+}
+
+bool UTS_WorldGenerator::IsChunkOutsideTerrainBounds(const FVector& ChunkWorldPos, int32 ChunkSize, float VoxelSize) const
+{
+	const float BottomZ = ChunkWorldPos.Z;
+	const float TopZ = ChunkWorldPos.Z + ((ChunkSize - 1) * VoxelSize);
+
+	// Highest possible terrain surface (CalculateTerrainHeight clamps the noise to this range)
+	const float MaxTerrainHeight = NoiseGenerator
+		? WorldGenParameters.MaxHeight + WorldGenParameters.BaseHeight
+		: WorldGenParameters.BaseHeight;
+
+	return BottomZ >= MaxTerrainHeight
+		|| BottomZ > WorldGenParameters.MaxHeight
+		|| TopZ < WorldGenParameters.MinHeight;
+}
+
+void UTS_WorldGenerator::BuildChunkHeightmap(const FVector& ChunkWorldPos, int32 ChunkSize, float VoxelSize, FTS_ChunkHeightmap& OutHeightmap) const
+{
+	const int32 NumColumns = ChunkSize * ChunkSize;
+	const bool bUseBiomes = BiomeManager && WorldGenParameters.bEnableBiomes;
+
+	OutHeightmap.Size = ChunkSize;
+	OutHeightmap.Heights.SetNumUninitialized(NumColumns);
+	OutHeightmap.Moisture.SetNumZeroed(NumColumns);
+	OutHeightmap.Temperature.SetNumZeroed(NumColumns);
+	OutHeightmap.SurfaceMaterialIDs.Reset();
+	if (bUseBiomes)
+	{
+		OutHeightmap.SurfaceMaterialIDs.SetNumUninitialized(NumColumns);
+	}
+	OutHeightmap.MinTerrainHeight = TNumericLimits<float>::Max();
+	OutHeightmap.MaxTerrainHeight = TNumericLimits<float>::Lowest();
+
+	// Each row of columns is sampled with the batch noise path
+	TArray<float> BiomeHeights;
+	if (bUseBiomes)
+	{
+		BiomeHeights.SetNumUninitialized(ChunkSize);
+	}
 
-				// Generate voxel at this location
-				FTS_VoxelGenResult Result = GenerateVoxelAtLocation(WorldX, WorldY, WorldZ);
+	for (int32 Y = 0; Y < ChunkSize; Y++)
+	{
+		const FVector RowStart(ChunkWorldPos.X, ChunkWorldPos.Y + (Y * VoxelSize), 0.0f);
+		const int32 RowOffset = OutHeightmap.GetIndex(0, Y);
+
+		TArrayView<float> HeightRow(OutHeightmap.Heights.GetData() + RowOffset, ChunkSize);
+		CalculateTerrainHeightRow(RowStart, VoxelSize, HeightRow);
+
+		for (const float TerrainHeight : HeightRow)
+		{
+			OutHeightmap.MinTerrainHeight = FMath::Min(OutHeightmap.MinTerrainHeight, TerrainHeight);
+			OutHeightmap.MaxTerrainHeight = FMath::Max(OutHeightmap.MaxTerrainHeight, TerrainHeight);
+		}
 
-				// Calculate array index
-				int32 Index = X + (Y * ChunkSize) + (Z * ChunkSize * ChunkSize);
+		if (bUseBiomes)
+		{
+			TArrayView<float> MoistureRow(OutHeightmap.Moisture.GetData() + RowOffset, ChunkSize);
+			TArrayView<float> TemperatureRow(OutHeightmap.Temperature.GetData() + RowOffset, ChunkSize);
+			BiomeManager->CalculateColumnClimateRow(RowStart, VoxelSize, BiomeHeights, MoistureRow, TemperatureRow);
 
-				// Store voxel data (0 = air, >0 = material ID)
-				OutVoxelData[Index] = Result.bIsSolid ? Result.MaterialID : 0;
+			for (int32 X = 0; X < ChunkSize; X++)
+			{
+				OutHeightmap.SurfaceMaterialIDs[RowOffset + X] = BiomeManager->GetMaterialIDForClimate(
+					BiomeHeights[X], MoistureRow[X], TemperatureRow[X], HeightRow[X]);
 			}
 		}
 	}
@@ -133,6 +310,35 @@ void UTS_WorldGenerator::RegenerateWorld(int32 NewSeed)
 	InitializeNoiseParameters();
 }
 
+uint32 UTS_WorldGenerator::GetParametersHash() const
+{
+	const FTS_WorldGenParameters& Params = WorldGenParameters;
+	uint32 Hash = GetTypeHash(Params.WorldSeed);
+	Hash = HashCombine(Hash, GetTypeHash(Params.BaseHeight));
+	Hash = HashCombine(Hash, GetTypeHash(Params.MaxHeight));
+	Hash = HashCombine(Hash, GetTypeHash(Params.MinHeight));
+	Hash = HashCombine(Hash, uint32(Params.bEnableCaves));
+	Hash = HashCombine(Hash, GetTypeHash(Params.CaveThreshold));
+	Hash = HashCombine(Hash, uint32(Params.bEnableBiomes));
+	Hash = HashCombine(Hash, uint32(Params.bEnableOres));
+
+	if (BiomeManager)
+	{
+		for (const FTS_Biome& Biome : BiomeManager->Biomes)
+		{
+			Hash = HashCombine(Hash, GetTypeHash(Biome.BiomeName));
+			Hash = HashCombine(Hash, GetTypeHash(Biome.HeightRange));
+			Hash = HashCombine(Hash, GetTypeHash(Biome.MoistureRange));
+			Hash = HashCombine(Hash, GetTypeHash(Biome.TemperatureRange));
+			Hash = HashCombine(Hash, GetTypeHash(Biome.PrimaryMaterialID));
+			Hash = HashCombine(Hash, GetTypeHash(Biome.SecondaryMaterialID));
+			Hash = HashCombine(Hash, GetTypeHash(Biome.Weight));
+			Hash = HashCombine(Hash, uint32(Biome.bEnabled));
+		}
+	}
+	return Hash;
+}
+
 bool UTS_WorldGenerator::ShouldVoxelBeSolid(float WorldX, float WorldY, float WorldZ, float TerrainHeight) const
 {
 	// Check if voxel is below terrain height
@@ -237,6 +443,34 @@ float UTS_WorldGenerator::CalculateTerrainHeight(float X, float Y) const
 	return Height;
 }
 
+void UTS_WorldGenerator::CalculateTerrainHeightRow(const FVector& Start, float StepX, TArrayView<float> OutHeights) const
+{
+	if (!NoiseGenerator)
+	{
+		for (float& Height : OutHeights)
+		{
+			Height = WorldGenParameters.BaseHeight;
+		}
+		return;
+	}
+
+	FTS_NoiseParameters HeightParams = TerrainNoiseParams;
+	HeightParams.Offset = FVector(0.0f, 0.0f, 0.0f);
+
+	UTS_ProceduralNoise::FractalNoiseBatch(FVector(Start.X, Start.Y, 0.0f), FVector(StepX, 0.0f, 0.0f), HeightParams, OutHeights);
+
+	// Same mapping as CalculateTerrainHeight
+	for (float& Height : OutHeights)
+	{
+		Height = FMath::GetMappedRangeValueClamped(
+			FVector2D(-1.0f, 1.0f),
+			FVector2D(WorldGenParameters.MinHeight, WorldGenParameters.MaxHeight),
+			Height
+		);
+		Height += WorldGenParameters.BaseHeight;
+	}
+}
+
 float UTS_WorldGenerator::CalculateCaveDensity(float X, float Y, float Z) const
 {
 	if (!NoiseGenerator || !WorldGenParameters.bEnableCaves)
@@ -2,7 +2,10 @@
 
 #include "CoreMinimal.h"
 #include "Engine/Engine.h"
+#include "Engine/DataAsset.h"
 #include "TS_ProceduralNoise.h"
+#include "TS_VoxelTypes.h"
+#include <atomic>
 #include "TS_WorldGenerator.generated.h"
 
 class UTS_ProceduralNoise;
@@ -62,6 +65,20 @@ struct TERRA_SCAPE_API FTS_WorldGenParameters
 	}
 };
 
+/**
+ * World generation parameters saved as an asset, so a world can be baked offline with the exact
+ * settings the game uses
+ */
+UCLASS(BlueprintType)
+class TERRA_SCAPE_API UTS_WorldGenParametersAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "TerraScape | Voxel | Procedural")
+	FTS_WorldGenParameters Parameters;
+};
+
 /**
  * Voxel generation result
  * UE 5.6 UHT Compliance: Defined in global scope without namespace
@@ -96,6 +113,39 @@ struct TERRA_SCAPE_API FTS_VoxelGenResult
 	}
 };
 
+/**
+ * Per-column terrain and climate data for one chunk
+ * Height, moisture and temperature only depend on X/Y, so they are computed once
+ * per column and the 3D fill only evaluates per-voxel (cave) noise
+ */
+struct TERRA_SCAPE_API FTS_ChunkHeightmap
+{
+	/** Number of columns along X and Y */
+	int32 Size = 0;
+
+	/** Terrain height per column (world units) */
+	TArray<float> Heights;
+
+	/** Moisture per column (0.0 - 1.0) */
+	TArray<float> Moisture;
+
+	/** Temperature per column (0.0 - 1.0) */
+	TArray<float> Temperature;
+
+	/** Biome material per column (only filled when biomes are enabled) */
+	TArray<int32> SurfaceMaterialIDs;
+
+	/** Lowest and highest terrain height in this chunk */
+	float MinTerrainHeight = 0.0f;
+	float MaxTerrainHeight = 0.0f;
+
+	/** Column index for local X/Y */
+	FORCEINLINE int32 GetIndex(int32 X, int32 Y) const
+	{
+		return X + (Y * Size);
+	}
+};
+
 /**
  * World generator for procedural terrain generation
  * Integrates noise functions, biomes, and material assignment
@@ -124,6 +174,42 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "TerraScape | Voxel | Procedural")
 	void GenerateChunkVoxels(int32 ChunkX, int32 ChunkY, int32 ChunkZ, int32 ChunkSize, float VoxelSize, TArray<int32>& OutVoxelData);
 
+	/**
+	 * Generate voxel data for a chunk whose origin is at the given world position
+	 * Builds the chunk heightmap once and fills the 3D volume from it; safe to call from worker threads.
+	 * Chunks that are entirely air or entirely one material are detected from the terrain bounds and
+	 * the heightmap min/max before any voxel is evaluated, and are returned as a single value.
+	 * @param ChunkWorldPos - World position of voxel (0,0,0) of the chunk
+	 * @param ChunkSize - Size of the chunk
+	 * @param VoxelSize - Size of each voxel
+	 * @param OutVoxelData - Output voxels, indexed X + Y * ChunkSize + Z * ChunkSize * ChunkSize (empty for uniform chunks)
+	 * @param OutUniformMaterialID - Material of every voxel when the chunk is uniform (0 = air)
+	 * @param bCancelled - Optional flag checked once per row; once set, generation stops and OutVoxelData is incomplete
+	 * @return True if the chunk is uniform and OutVoxelData was not filled
+	 */
+	bool GenerateChunkVoxelData(const FVector& ChunkWorldPos, int32 ChunkSize, float VoxelSize, TArray<FTS_Voxel>& OutVoxelData, int32& OutUniformMaterialID, 
+		const std::atomic<bool>* bCancelled = nullptr) const;
+
+	/**
+	 * Check a chunk against the conservative terrain bounds without sampling any noise
+	 * Terrain height is clamped to [MinHeight, MaxHeight] + BaseHeight and solid voxels only
+	 * exist between MinHeight and MaxHeight, so chunks outside those bands are always air
+	 * @param ChunkWorldPos - World position of voxel (0,0,0) of the chunk
+	 * @param ChunkSize - Size of the chunk
+	 * @param VoxelSize - Size of each voxel
+	 * @return True if every voxel of the chunk is guaranteed to be air
+	 */
+	bool IsChunkOutsideTerrainBounds(const FVector& ChunkWorldPos, int32 ChunkSize, float VoxelSize) const;
+
+	/**
+	 * Compute the per-column height and climate maps for a chunk
+	 * @param ChunkWorldPos - World position of voxel (0,0,0) of the chunk
+	 * @param ChunkSize - Size of the chunk
+	 * @param VoxelSize - Size of each voxel
+	 * @param OutHeightmap - Output heightmap
+	 */
+	void BuildChunkHeightmap(const FVector& ChunkWorldPos, int32 ChunkSize, float VoxelSize, FTS_ChunkHeightmap& OutHeightmap) const;
+
 	/**
 	 * Generate voxel data for a single voxel at world coordinates
 	 * @param WorldX, WorldY, WorldZ - World coordinates
@@ -167,6 +253,12 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "TerraScape | Voxel | Procedural")
 	void RegenerateWorld(int32 NewSeed);
 
+	/**
+	 * Hash of every setting that shapes the terrain (parameters and biomes), stable across runs
+	 * @return Equal for two generators that produce the same voxels
+	 */
+	uint32 GetParametersHash() const;
+
 	/**
 	 * Check if a voxel should be solid based on height and cave generation
 	 * @param WorldX, WorldY, WorldZ - World coordinates
@@ -228,6 +320,14 @@ private:
 	 */
 	float CalculateTerrainHeight(float X, float Y) const;
 
+	/**
+	 * Calculate terrain height for a row of columns along X
+	 * @param Start - World coordinates of the first column
+	 * @param StepX - World space distance between columns
+	 * @param OutHeights - Output terrain heights, one per column
+	 */
+	void CalculateTerrainHeightRow(const FVector& Start, float StepX, TArrayView<float> OutHeights) const;
+
 	/**
 	 * Calculate cave density at given coordinates
 	 * @param X, Y, Z - World coordinates
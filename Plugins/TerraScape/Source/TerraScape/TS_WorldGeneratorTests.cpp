@@ -0,0 +1,86 @@
+/**
+ * @file TS_WorldGeneratorTests.cpp
+ * @brief Automation tests for TerraScape world generation
+ * @author Keves
+ * @version 1.0
+ */
+
+#include "TS_WorldGenerator.h"
+#include "Async/ParallelFor.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTS_GenerationDeterminismTest, "TerraScape.WorldGenerator.Determinism",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * Generates a block of chunks single-threaded and again with ParallelFor for a fixed seed; the voxel
+ * output must be identical
+ */
+bool FTS_GenerationDeterminismTest::RunTest(const FString& Parameters)
+{
+	const int32 NumChunks = 32;
+	const int32 ChunkSize = 32;
+	const float VoxelSize = 100.0f;
+
+	UTS_WorldGenerator* WorldGenerator = NewObject<UTS_WorldGenerator>();
+	WorldGenerator->RegenerateWorld(1337);
+
+	// Lay the chunks out in a 4-wide grid straddling the surface so caves and biomes are exercised
+	const float ChunkWorldSize = ChunkSize * VoxelSize;
+	auto GetChunkOrigin = [ChunkWorldSize](int32 ChunkIndex)
+	{
+		return FVector(
+			(ChunkIndex % 4) * ChunkWorldSize,
+			((ChunkIndex / 4) % 4) * ChunkWorldSize,
+			((ChunkIndex / 16) - 1) * ChunkWorldSize * 0.5f
+		);
+	};
+
+	// Uniform chunks record their material instead of a voxel array (INDEX_NONE = not uniform)
+	TArray<TArray<FTS_Voxel>> SingleThreaded;
+	TArray<int32> SingleThreadedUniform;
+	SingleThreaded.SetNum(NumChunks);
+	SingleThreadedUniform.Init(INDEX_NONE, NumChunks);
+	for (int32 ChunkIndex = 0; ChunkIndex < NumChunks; ChunkIndex++)
+	{
+		int32 UniformMaterialID = 0;
+		if (WorldGenerator->GenerateChunkVoxelData(GetChunkOrigin(ChunkIndex), ChunkSize, VoxelSize, SingleThreaded[ChunkIndex], UniformMaterialID))
+		{
+			SingleThreadedUniform[ChunkIndex] = UniformMaterialID;
+		}
+	}
+
+	TArray<TArray<FTS_Voxel>> MultiThreaded;
+	TArray<int32> MultiThreadedUniform;
+	MultiThreaded.SetNum(NumChunks);
+	MultiThreadedUniform.Init(INDEX_NONE, NumChunks);
+	ParallelFor(NumChunks, [&](int32 ChunkIndex)
+	{
+		int32 UniformMaterialID = 0;
+		if (WorldGenerator->GenerateChunkVoxelData(GetChunkOrigin(ChunkIndex), ChunkSize, VoxelSize, MultiThreaded[ChunkIndex], UniformMaterialID))
+		{
+			MultiThreadedUniform[ChunkIndex] = UniformMaterialID;
+		}
+	});
+
+	for (int32 ChunkIndex = 0; ChunkIndex < NumChunks; ChunkIndex++)
+	{
+		const TArray<FTS_Voxel>& A = SingleThreaded[ChunkIndex];
+		const TArray<FTS_Voxel>& B = MultiThreaded[ChunkIndex];
+
+		bool bMatches = SingleThreadedUniform[ChunkIndex] == MultiThreadedUniform[ChunkIndex] && A.Num() == B.Num();
+		for (int32 Index = 0; bMatches && Index < A.Num(); Index++)
+		{
+			bMatches = A[Index].MaterialID == B[Index].MaterialID;
+		}
+
+		TestTrue(FString::Printf(TEXT("Chunk %d at %s matches between single- and multi-threaded generation"),
+			ChunkIndex, *GetChunkOrigin(ChunkIndex).ToString()), bMatches);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -6,6 +6,7 @@
  */
 
 #include "TerraScape.h"
+#include "TS_Stats.h"
 
 #define LOCTEXT_NAMESPACE "FTerraScapeModule"
 
@@ -16,7 +17,7 @@ namespace TerraScape
 		// Initialize TerraScape sub-modules
 		InitializeSubModules();
 		
-		UE_LOG(LogTemp, Log, TEXT("TerraScape Module: Started successfully"));
+		UE_LOG(LogTerraScape, Log, TEXT("TerraScape Module: Started successfully"));
 	}
 
 	void FTerraScapeModule::ShutdownModule()
@@ -24,7 +25,7 @@ namespace TerraScape
 		// Shutdown TerraScape sub-modules
 		ShutdownSubModules();
 		
-		UE_LOG(LogTemp, Log, TEXT("TerraScape Module: Shutdown complete"));
+		UE_LOG(LogTerraScape, Log, TEXT("TerraScape Module: Shutdown complete"));
 	}
 
 	void FTerraScapeModule::InitializeSubModules()
@@ -33,13 +34,13 @@ namespace TerraScape
 		// Note: TS_ChunkManager is now a component, not a separate module
 		// Other modules have been removed for MVP
 		
-		UE_LOG(LogTemp, Log, TEXT("TerraScape: Sub-modules initialized (MVP mode)"));
+		UE_LOG(LogTerraScape, Log, TEXT("TerraScape: Sub-modules initialized (MVP mode)"));
 	}
 
 	void FTerraScapeModule::ShutdownSubModules()
 	{
 		// Shutdown sub-modules (MVP mode - no additional modules to unload)
-		UE_LOG(LogTemp, Log, TEXT("TerraScape: Sub-modules shutdown (MVP mode)"));
+		UE_LOG(LogTerraScape, Log, TEXT("TerraScape: Sub-modules shutdown (MVP mode)"));
 	}
 }
 